@@ -0,0 +1,67 @@
+#include "AdjacencyIndex.h"
+
+using std::get_if;
+
+AdjacencyStorage AdjacencyIndex::chooseStorage(size_t numberOfNodes, size_t expectedLinks) {
+  // The matrix takes n² / 16 bytes, the table about 32 bytes per link. Lookups in the matrix are cheaper,
+  // so it is kept while it is within four times the table.
+  auto denseBytes = double(numberOfNodes) * double(numberOfNodes) / 16;
+  auto sparseBytes = 32. * double(expectedLinks) + 128;
+  return denseBytes <= 4 * sparseBytes ? AdjacencyStorage::Dense : AdjacencyStorage::Sparse;
+}
+
+void AdjacencyIndex::reset(size_t numberOfNodes, size_t expectedLinks, AdjacencyStorage adjacencyStorage) {
+  if (adjacencyStorage == AdjacencyStorage::Automatic) {
+    adjacencyStorage = chooseStorage(numberOfNodes, expectedLinks);
+  }
+  if (adjacencyStorage == AdjacencyStorage::Dense) {
+    storage.emplace<TriangleBoolSquareMatrix>(numberOfNodes);
+  } else {
+    storage.emplace<SparseAdjacency>().reset(numberOfNodes, expectedLinks);
+  }
+}
+
+bool AdjacencyIndex::isDense() const {
+  return storage.index() == 0;
+}
+
+const TriangleBoolSquareMatrix *AdjacencyIndex::getMatrix() const {
+  return get_if<TriangleBoolSquareMatrix>(&storage);
+}
+
+size_t AdjacencyIndex::getDimension() const {
+  if (const auto *matrix = get_if<TriangleBoolSquareMatrix>(&storage)) {
+    return matrix->getDimension();
+  }
+  return get_if<SparseAdjacency>(&storage)->getDimension();
+}
+
+bool AdjacencyIndex::areAdjacent(size_t i, size_t j) const {
+  if (i == j) {
+    return false;
+  }
+  if (const auto *matrix = get_if<TriangleBoolSquareMatrix>(&storage)) {
+    return i > j ? matrix->at(i, j) : matrix->at(j, i);
+  }
+  return get_if<SparseAdjacency>(&storage)->contains(i, j);
+}
+
+void AdjacencyIndex::addLink(size_t i, size_t j) {
+  if (auto *matrix = get_if<TriangleBoolSquareMatrix>(&storage)) {
+    if (i > j) {
+      matrix->at(i, j) = true;
+    } else {
+      matrix->at(j, i) = true;
+    }
+  } else {
+    get_if<SparseAdjacency>(&storage)->insert(i, j);
+  }
+}
+
+size_t AdjacencyIndex::getMemoryUsage() const {
+  if (const auto *matrix = get_if<TriangleBoolSquareMatrix>(&storage)) {
+    auto n = matrix->getDimension();
+    return (n + 1) * sizeof(size_t) + (n * n / 2 + 63 * n) / 8;
+  }
+  return get_if<SparseAdjacency>(&storage)->getMemoryUsage();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "TriangleBoolSquareMatrix.h"
+#include "SparseAdjacency.h"
+#include <variant>
+
+using std::variant;
+
+enum class AdjacencyStorage {
+  // Dense while its matrix takes less memory than a few times the sparse table
+  Automatic,
+  // Bit matrix, constant memory per pair of nodes
+  Dense,
+  // Hash set of links, memory in proportion to the number of links
+  Sparse
+};
+
+// Adjacency of graph nodes stored either as a bit matrix or as a hash set of links
+class AdjacencyIndex {
+  variant<TriangleBoolSquareMatrix, SparseAdjacency> storage;
+
+public:
+  [[nodiscard]] static AdjacencyStorage chooseStorage(size_t numberOfNodes, size_t expectedLinks);
+
+  // Drops all links
+  void reset(size_t numberOfNodes, size_t expectedLinks,
+             AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic);
+
+  [[nodiscard]] bool isDense() const;
+
+  // Null for the sparse storage
+  [[nodiscard]] const TriangleBoolSquareMatrix *getMatrix() const;
+
+  [[nodiscard]] size_t getDimension() const;
+
+  // Nodes are never adjacent to themselves
+  [[nodiscard]] bool areAdjacent(size_t i, size_t j) const;
+
+  void addLink(size_t i, size_t j);
+
+  [[nodiscard]] size_t getMemoryUsage() const;
+};
@@ -0,0 +1,70 @@
+#include "BatchGenerator.h"
+#include <atomic>
+#include <thread>
+
+using std::atomic;
+using std::thread;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
+using std::seed_seq;
+using std::to_string;
+using std::min;
+using std::max;
+
+BatchGenerator::BatchGenerator(size_t numberOfThreads, unsigned seed) : numberOfThreads(numberOfThreads), seed(seed) {
+  if (this->numberOfThreads == 0) {
+    this->numberOfThreads = max(1u, thread::hardware_concurrency());
+  }
+}
+
+void BatchGenerator::run(size_t numberOfGraphs, const string &namePrefix,
+                         const function<Graph(mt19937 &)> &generate) const {
+  atomic<size_t> nextGraph(0);
+  atomic<bool> failed(false);
+  exception_ptr failure;
+
+  auto work = [&]() {
+    mt19937 engine;
+    for (size_t i = nextGraph++; i < numberOfGraphs && !failed; i = nextGraph++) {
+      try {
+        seed_seq graphSeed{seed, unsigned(i), unsigned(i >> 32u)};
+        engine.seed(graphSeed);
+        generate(engine).save(namePrefix + to_string(i));
+      } catch (...) {
+        if (!failed.exchange(true)) {
+          failure = current_exception();
+        }
+      }
+    }
+  };
+
+  vector<thread> workers;
+  for (size_t i = 0; i < min(numberOfThreads, numberOfGraphs); ++i) {
+    workers.emplace_back(work);
+  }
+  for (auto &worker:workers) {
+    worker.join();
+  }
+
+  if (failure) {
+    rethrow_exception(failure);
+  }
+}
+
+void BatchGenerator::generatePlanar(size_t numberOfGraphs, size_t numberOfVertices, double maxCoord,
+                                    const string &namePrefix, PlanarLinkSampling linkSampling) const {
+  // Workers get the radius read here, not the settings
+  auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+  run(numberOfGraphs, namePrefix, [=](mt19937 &engine) {
+    return Graph::generatePlanar(numberOfVertices, maxCoord, nodeRadius, engine, linkSampling);
+  });
+}
+
+void BatchGenerator::generateDelaunayPlanar(size_t numberOfGraphs, size_t numberOfVertices, double maxCoord,
+                                            double linkFraction, const string &namePrefix) const {
+  auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+  run(numberOfGraphs, namePrefix, [=](mt19937 &engine) {
+    return Graph::generateDelaunayPlanar(numberOfVertices, maxCoord, nodeRadius, linkFraction, engine);
+  });
+}
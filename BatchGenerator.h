@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Graph.h"
+#include <functional>
+
+using std::function;
+
+// Generates graphs on a pool of threads and saves them through Graph::save as namePrefix + index.
+// Graph i is generated from an engine seeded with (seed, i), so the output does not depend on the number of threads.
+class BatchGenerator {
+  size_t numberOfThreads;
+  unsigned seed;
+
+  void run(size_t numberOfGraphs, const string &namePrefix, const function<Graph(mt19937 &)> &generate) const;
+
+public:
+  // Zero threads means one per hardware thread
+  BatchGenerator(size_t numberOfThreads, unsigned seed);
+
+  void generatePlanar(size_t numberOfGraphs, size_t numberOfVertices, double maxCoord, const string &namePrefix,
+                      PlanarLinkSampling linkSampling = PlanarLinkSampling::RandomPairs) const;
+
+  void generateDelaunayPlanar(size_t numberOfGraphs, size_t numberOfVertices, double maxCoord, double linkFraction,
+                              const string &namePrefix) const;
+};
@@ -0,0 +1,212 @@
+#include "BatchRenderer.h"
+#include "BoundedQueue.h"
+#include "TextFactory.h"
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+namespace fs = std::filesystem;
+using std::atomic;
+using std::thread;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
+using std::numeric_limits;
+using std::streamsize;
+using std::runtime_error;
+using std::max;
+using std::min;
+
+// Seconds since start
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double BatchRenderStats::getGraphsPerSecond() const {
+  return totalSeconds > 0 ? double(numberOfGraphs) / totalSeconds : 0;
+}
+
+BatchRenderer::BatchRenderer(size_t numberOfParseThreads, size_t numberOfEncodeThreads, RenderBackend backend,
+                             unsigned imageSize)
+    : numberOfParseThreads(numberOfParseThreads), numberOfEncodeThreads(numberOfEncodeThreads), backend(backend),
+      imageSize(imageSize) {
+  if (this->numberOfParseThreads == 0) {
+    this->numberOfParseThreads = max(1u, thread::hardware_concurrency());
+  }
+  if (this->numberOfEncodeThreads == 0) {
+    this->numberOfEncodeThreads = max(1u, thread::hardware_concurrency());
+  }
+}
+
+BatchRenderStats BatchRenderer::render(const string &directory, const string &imagePrefix) const {
+  auto start = std::chrono::steady_clock::now();
+  // Parsers index their graphs with the radius read here, not the settings
+  auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+  // Glyphs of the names are ready before the first graph, so its drawing does not pay for them
+  TextFactory::getTextFactory().preloadGlyphs(TextFactory::nameCharacters, backend);
+  vector<fs::path> paths;
+  for (const auto &entry:fs::directory_iterator(directory)) {
+    auto fileName = entry.path().filename().string();
+    if (fileName.find("test_") == 0 && fileName.find("_result") == string::npos) {
+      paths.push_back(entry.path());
+    }
+  }
+
+  struct ParsedGraph {
+    string name;
+    Graph graph;
+  };
+  struct RenderedImage {
+    string name;
+    sf::Image image;
+  };
+  // A few items per thread keep every stage busy
+  BoundedQueue<ParsedGraph> parsedGraphs(2 * numberOfParseThreads);
+  BoundedQueue<RenderedImage> renderedImages(2 * numberOfEncodeThreads);
+
+  atomic<size_t> nextPath(0), runningParsers(0);
+  atomic<bool> failed(false);
+  exception_ptr failure;
+  mutex statsMutex;
+  BatchRenderStats stats;
+
+  auto fail = [&]() {
+    lock_guard<mutex> lock(statsMutex);
+    if (!failed.exchange(true)) {
+      failure = current_exception();
+    }
+    parsedGraphs.close();
+    renderedImages.close();
+  };
+
+  auto parse = [&]() {
+    double seconds = 0, renderSeconds = 0;
+    size_t numberOfGraphs = 0;
+    SoftwareRasterizer rasterizer(backend == RenderBackend::Software ? imageSize : 0, imageSize);
+    for (size_t i = nextPath++; i < paths.size() && !failed; i = nextPath++) {
+      try {
+        auto parseStart = std::chrono::steady_clock::now();
+        auto fileName = paths[i].filename().string();
+        ifstream matrixIn(paths[i]);
+        matrixIn.ignore(numeric_limits<streamsize>::max(), '\n');
+        matrixIn.ignore(numeric_limits<streamsize>::max(), '\n');
+        ifstream nodesIn("nodes/" + fileName);
+        ParsedGraph parsed{fileName, Graph(nodeRadius)};
+        parsed.graph.load(matrixIn, nodesIn);
+
+        ifstream subgraphIn(paths[i].string() + "_result");
+        vector<size_t> subgraph;
+        while (subgraphIn && subgraphIn.get() != '}') {
+          size_t node;
+          subgraphIn >> node;
+          subgraph.push_back(node);
+        }
+        parsed.graph.showSubgraph(subgraph);
+        seconds += secondsSince(parseStart);
+        if (backend == RenderBackend::OpenGL) {
+          if (!parsedGraphs.push(std::move(parsed))) {
+            break;
+          }
+          continue;
+        }
+
+        // Without GL every parser draws its own graphs
+        auto renderStart = std::chrono::steady_clock::now();
+        rasterizer.clear(sf::Color::White);
+        parsed.graph.rasterize(rasterizer);
+        RenderedImage rendered{std::move(parsed.name), rasterizer.copyToImage()};
+        renderSeconds += secondsSince(renderStart);
+        if (!renderedImages.push(std::move(rendered))) {
+          break;
+        }
+        ++numberOfGraphs;
+      } catch (...) {
+        fail();
+      }
+    }
+    lock_guard<mutex> lock(statsMutex);
+    stats.parseSeconds += seconds;
+    stats.renderSeconds += renderSeconds;
+    stats.numberOfGraphs += numberOfGraphs;
+    // The last parser to finish tells the next stage that no more graphs come
+    if (--runningParsers == 0) {
+      parsedGraphs.close();
+      if (backend == RenderBackend::Software) {
+        renderedImages.close();
+      }
+    }
+  };
+
+  auto encode = [&]() {
+    double seconds = 0;
+    while (auto rendered = renderedImages.pop()) {
+      try {
+        auto encodeStart = std::chrono::steady_clock::now();
+        if (!rendered->image.saveToFile(imagePrefix + rendered->name + "_sel.png")) {
+          throw runtime_error("Unable to save " + imagePrefix + rendered->name + "_sel.png");
+        }
+        seconds += secondsSince(encodeStart);
+      } catch (...) {
+        fail();
+      }
+    }
+    lock_guard<mutex> lock(statsMutex);
+    stats.encodeSeconds += seconds;
+  };
+
+  auto numberOfParsers = max(min(numberOfParseThreads, paths.size()), size_t(1));
+  runningParsers = numberOfParsers;
+  vector<thread> parsers, encoders;
+  for (size_t i = 0; i < numberOfParsers; ++i) {
+    parsers.emplace_back(parse);
+  }
+  for (size_t i = 0; i < numberOfEncodeThreads; ++i) {
+    encoders.emplace_back(encode);
+  }
+
+  // Textures live in the context of the thread that made them, so all GL drawing stays on this one
+  if (backend == RenderBackend::OpenGL) {
+    double renderSeconds = 0;
+    size_t numberOfGraphs = 0;
+    try {
+      sf::RenderTexture texture;
+      if (!texture.create(imageSize, imageSize)) {
+        throw runtime_error("Unable to create a render texture");
+      }
+      DiscTexture discTexture;
+      while (auto parsed = parsedGraphs.pop()) {
+        auto renderStart = std::chrono::steady_clock::now();
+        texture.clear(sf::Color::White);
+        parsed->graph.draw(texture, sf::RenderStates::Default, discTexture);
+        texture.display();
+        RenderedImage rendered{std::move(parsed->name), texture.getTexture().copyToImage()};
+        renderSeconds += secondsSince(renderStart);
+        if (!renderedImages.push(std::move(rendered))) {
+          break;
+        }
+        ++numberOfGraphs;
+      }
+    } catch (...) {
+      fail();
+    }
+    renderedImages.close();
+    lock_guard<mutex> lock(statsMutex);
+    stats.renderSeconds += renderSeconds;
+    stats.numberOfGraphs += numberOfGraphs;
+  }
+
+  for (auto &parser:parsers) {
+    parser.join();
+  }
+  for (auto &encoder:encoders) {
+    encoder.join();
+  }
+  if (failure) {
+    rethrow_exception(failure);
+  }
+  stats.totalSeconds = secondsSince(start);
+  return stats;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Graph.h"
+
+// Seconds spent in each stage summed over its threads, and the whole run
+struct BatchRenderStats {
+  size_t numberOfGraphs = 0;
+  double parseSeconds = 0;
+  double renderSeconds = 0;
+  double encodeSeconds = 0;
+  double totalSeconds = 0;
+
+  [[nodiscard]] double getGraphsPerSecond() const;
+};
+
+// Renders the selected subgraphs of test results into PNG images as a pipeline: a pool of threads parses the
+// graphs, the calling thread draws them one by one into a single render texture, and another pool encodes and
+// writes the images while the next graph is drawn. The software backend needs no context, so the parsers draw
+// their graphs themselves. Queues between the stages are bounded, so parsing ahead of drawing holds only a few
+// graphs in memory.
+class BatchRenderer {
+  size_t numberOfParseThreads, numberOfEncodeThreads;
+  RenderBackend backend;
+  unsigned imageSize;
+
+public:
+  // Zero threads of a stage means one per hardware thread, images are imageSize pixels square
+  BatchRenderer(size_t numberOfParseThreads, size_t numberOfEncodeThreads,
+                RenderBackend backend = RenderBackend::OpenGL, unsigned imageSize = 600);
+
+  // Every "test_*" file of the directory but the "_result" ones is a matrix after two lines of header. Its nodes
+  // are in "nodes/" under the same name and the selected nodes in the file with "_result" appended, the image is
+  // saved as imagePrefix + name + "_sel.png". Rethrows the first error after stopping all stages.
+  [[nodiscard]] BatchRenderStats render(const string &directory, const string &imagePrefix) const;
+};
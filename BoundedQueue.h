@@ -0,0 +1,77 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+
+using std::deque;
+using std::mutex;
+using std::condition_variable;
+using std::unique_lock;
+using std::lock_guard;
+using std::optional;
+using std::nullopt;
+
+// Queue between the threads of a pipeline, holding at most capacity items so that a fast stage waits for a slow one
+// instead of piling up its output
+template<typename Item>
+class BoundedQueue {
+  size_t capacity;
+  deque<Item> items;
+  bool closed = false;
+  mutex itemsMutex;
+  condition_variable notFull, notEmpty;
+
+public:
+  explicit BoundedQueue(size_t capacity);
+
+  // Waits for room, false when the queue was closed
+  bool push(Item item);
+
+  // Waits for an item, nullopt once the queue is closed and empty
+  optional<Item> pop();
+
+  // Wakes everyone waiting, items pushed before are still popped
+  void close();
+};
+
+template<typename Item>
+BoundedQueue<Item>::BoundedQueue(size_t capacity) : capacity(capacity) {}
+
+template<typename Item>
+bool BoundedQueue<Item>::push(Item item) {
+  unique_lock<mutex> lock(itemsMutex);
+  notFull.wait(lock, [this]() {
+    return closed || items.size() < capacity;
+  });
+  if (closed) {
+    return false;
+  }
+  items.push_back(std::move(item));
+  notEmpty.notify_one();
+  return true;
+}
+
+template<typename Item>
+optional<Item> BoundedQueue<Item>::pop() {
+  unique_lock<mutex> lock(itemsMutex);
+  notEmpty.wait(lock, [this]() {
+    return closed || !items.empty();
+  });
+  if (items.empty()) {
+    return nullopt;
+  }
+  auto item = std::move(items.front());
+  items.pop_front();
+  notFull.notify_one();
+  return item;
+}
+
+template<typename Item>
+void BoundedQueue<Item>::close() {
+  lock_guard<mutex> lock(itemsMutex);
+  closed = true;
+  notFull.notify_all();
+  notEmpty.notify_all();
+}
@@ -0,0 +1,41 @@
+#include "CandidateEdgeSampler.h"
+#include <algorithm>
+
+using std::move;
+using std::swap;
+using std::sort;
+using std::unique;
+using std::uniform_int_distribution;
+
+void CandidateEdgeSampler::fill(vector<pair<size_t, size_t>> newCandidates) {
+  candidates = move(newCandidates);
+  for (auto &candidate:candidates) {
+    if (candidate.first > candidate.second) {
+      swap(candidate.first, candidate.second);
+    }
+  }
+  sort(candidates.begin(), candidates.end());
+  candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+void CandidateEdgeSampler::clear() {
+  candidates.clear();
+  candidates.shrink_to_fit();
+}
+
+bool CandidateEdgeSampler::empty() const {
+  return candidates.empty();
+}
+
+size_t CandidateEdgeSampler::size() const {
+  return candidates.size();
+}
+
+pair<size_t, size_t> CandidateEdgeSampler::take(mt19937 &engine) {
+  uniform_int_distribution<size_t> distribution(0, candidates.size() - 1);
+  auto index = distribution(engine);
+  auto candidate = candidates[index];
+  candidates[index] = candidates.back();
+  candidates.pop_back();
+  return candidate;
+}
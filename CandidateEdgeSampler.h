@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <utility>
+
+using std::vector;
+using std::pair;
+using std::mt19937;
+
+// Pool of node pairs which may still be linked, pairs are drawn at random without replacement
+class CandidateEdgeSampler {
+  vector<pair<size_t, size_t>> candidates;
+
+public:
+  // Pairs are normalized, so (a, b) and (b, a) are kept once
+  void fill(vector<pair<size_t, size_t>> newCandidates);
+
+  void clear();
+
+  [[nodiscard]] bool empty() const;
+
+  [[nodiscard]] size_t size() const;
+
+  pair<size_t, size_t> take(mt19937 &engine);
+};
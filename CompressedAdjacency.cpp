@@ -0,0 +1,74 @@
+#include "CompressedAdjacency.h"
+#include <algorithm>
+
+using std::sort;
+using std::max;
+using std::min;
+
+void appendVarint(vector<uint8_t> &bytes, uint64_t value) {
+  while (value >= 0x80u) {
+    bytes.push_back(uint8_t(value | 0x80u));
+    value >>= 7u;
+  }
+  bytes.push_back(uint8_t(value));
+}
+
+// Neighbours of a row given in increasing order
+void appendRow(vector<uint8_t> &bytes, const GraphCore::NodeId *first, const GraphCore::NodeId *last) {
+  appendVarint(bytes, uint64_t(last - first));
+  uint64_t next = 0;
+  for (const auto *neighbour = first; neighbour != last; ++neighbour) {
+    appendVarint(bytes, *neighbour - next);
+    next = uint64_t(*neighbour) + 1;
+  }
+}
+
+vector<uint8_t> encodeAdjacency(size_t numberOfNodes, const vector<pair<GraphCore::NodeId, GraphCore::NodeId>> &links) {
+  // Lower neighbours of every node packed by a counting sort, then sorted within rows
+  vector<size_t> offsets(numberOfNodes + 1);
+  for (const auto &[first, second]:links) {
+    if (first == second || max(first, second) >= numberOfNodes) {
+      throw runtime_error("Link " + to_string(first) + " " + to_string(second) + " cannot be encoded");
+    }
+    ++offsets[max(first, second) + 1];
+  }
+  for (size_t i = 0; i < numberOfNodes; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  vector<GraphCore::NodeId> neighbours(links.size());
+  {
+    vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+    for (const auto &[first, second]:links) {
+      neighbours[positions[max(first, second)]++] = min(first, second);
+    }
+  }
+
+  vector<uint8_t> bytes;
+  bytes.reserve(numberOfNodes + 2 * links.size());
+  for (size_t i = 0; i < numberOfNodes; ++i) {
+    auto *first = neighbours.data() + offsets[i], *last = neighbours.data() + offsets[i + 1];
+    sort(first, last);
+    if (std::adjacent_find(first, last) != last) {
+      throw runtime_error("Node " + to_string(i) + " has a repeated link");
+    }
+    appendRow(bytes, first, last);
+  }
+  return bytes;
+}
+
+vector<uint8_t> encodeAdjacency(const TriangleBoolSquareMatrix &matrix) {
+  auto n = matrix.getDimension();
+  vector<uint8_t> bytes;
+  vector<GraphCore::NodeId> row;
+  for (size_t i = 0; i < n; ++i) {
+    row.clear();
+    const auto *words = matrix.getRowWords(i);
+    for (size_t k = 0; k < TriangleBoolSquareMatrix::getWordCount(i); ++k) {
+      for (auto word = words[k]; word != 0; word &= word - 1) {
+        row.push_back(GraphCore::NodeId(k * 64 + TriangleBoolSquareMatrix::getLowestBit(word)));
+      }
+    }
+    appendRow(bytes, row.data(), row.data() + row.size());
+  }
+  return bytes;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "GraphCore.h"
+#include "TriangleBoolSquareMatrix.h"
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+using std::vector;
+using std::runtime_error;
+using std::to_string;
+
+// Adjacency of n nodes as rows of their neighbours j < i in increasing order. A row is the varint of its length,
+// then varints of its first neighbour and of the gaps between consecutive neighbours minus one. Varints take
+// 7 bits a byte, lowest first, the high bit of a byte telling that more follow. Neighbours of nodes placed
+// nearby tend to have close ids, so sparse graphs take one or two bytes a link.
+vector<uint8_t> encodeAdjacency(size_t numberOfNodes, const vector<pair<GraphCore::NodeId, GraphCore::NodeId>> &links);
+
+vector<uint8_t> encodeAdjacency(const TriangleBoolSquareMatrix &matrix);
+
+// Calls onLink(i, j) for every link with j < i row by row, throws if the encoding is corrupted
+template<typename Function>
+void decodeAdjacency(const uint8_t *data, size_t size, size_t numberOfNodes, Function onLink) {
+  const uint8_t *position = data, *end = data + size;
+  auto readVarint = [&position, end]() {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (position == end) {
+        throw runtime_error("Compressed adjacency ends inside a number");
+      }
+      uint8_t byte = *position++;
+      value |= uint64_t(byte & 0x7fu) << shift;
+      if ((byte & 0x80u) == 0) {
+        return value;
+      }
+    }
+    throw runtime_error("Compressed adjacency has a number longer than 64 bits");
+  };
+
+  for (size_t i = 0; i < numberOfNodes; ++i) {
+    auto degree = readVarint();
+    if (degree > i) {
+      throw runtime_error("Row " + to_string(i) + " of compressed adjacency has " + to_string(degree) + " links");
+    }
+    uint64_t j = 0;
+    for (uint64_t k = 0; k < degree; ++k) {
+      // Gaps are checked one by one, so their sum cannot wrap around
+      auto gap = readVarint();
+      if (gap >= i - j) {
+        throw runtime_error("Row " + to_string(i) + " of compressed adjacency goes past the diagonal");
+      }
+      j += gap;
+      onLink(i, size_t(j));
+      ++j;
+    }
+  }
+  if (position != end) {
+    throw runtime_error("Compressed adjacency has data after its last row");
+  }
+}
@@ -0,0 +1,317 @@
+#include "Delaunay.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using std::move;
+using std::swap;
+using std::sort;
+using std::iota;
+using std::numeric_limits;
+
+double getCircumradius(double ax, double ay, double bx, double by, double cx, double cy) {
+  double dx = bx - ax, dy = by - ay, ex = cx - ax, ey = cy - ay;
+  double bl = dx * dx + dy * dy, cl = ex * ex + ey * ey;
+  double d = .5 / (dx * ey - dy * ex);
+  double x = (ey * bl - dy * cl) * d, y = (dx * cl - ex * bl) * d;
+  if (bl > 0 && cl > 0 && d != 0 && std::isfinite(d)) {
+    return x * x + y * y;
+  }
+  return numeric_limits<double>::max();
+}
+
+pair<double, double> getCircumcenter(double ax, double ay, double bx, double by, double cx, double cy) {
+  double dx = bx - ax, dy = by - ay, ex = cx - ax, ey = cy - ay;
+  double bl = dx * dx + dy * dy, cl = ex * ex + ey * ey;
+  double d = .5 / (dx * ey - dy * ex);
+  return {ax + (ey * bl - dy * cl) * d, ay + (dx * cl - ex * bl) * d};
+}
+
+bool isInCircle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py) {
+  double dx = ax - px, dy = ay - py, ex = bx - px, ey = by - py, fx = cx - px, fy = cy - py;
+  double ap = dx * dx + dy * dy, bp = ex * ex + ey * ey, cp = fx * fx + fy * fy;
+  return dx * (ey * cp - bp * fy) - dy * (ex * cp - bp * fx) + ap * (ex * fy - ey * fx) < 0;
+}
+
+// Monotonic in the angle of (dx, dy), but cheaper than atan2
+double getPseudoAngle(double dx, double dy) {
+  double p = dx / (std::abs(dx) + std::abs(dy));
+  return (dy > 0 ? 3 - p : 1 + p) / 4;
+}
+
+Delaunay::Delaunay(vector<double> xs, vector<double> ys) : xs(move(xs)), ys(move(ys)) {
+  triangulate();
+}
+
+size_t Delaunay::hashKey(double x, double y) const {
+  return size_t(std::floor(getPseudoAngle(x - centerX, y - centerY) * double(hashSize))) % hashSize;
+}
+
+bool Delaunay::orient(size_t p, size_t q, size_t r) const {
+  return orient(xs[p], ys[p], q, r);
+}
+
+bool Delaunay::orient(double px, double py, size_t q, size_t r) const {
+  return (ys[q] - py) * (xs[r] - xs[q]) - (xs[q] - px) * (ys[r] - ys[q]) < 0;
+}
+
+void Delaunay::link(size_t firstEdge, size_t secondEdge) {
+  halfEdges[firstEdge] = secondEdge;
+  if (secondEdge != none) {
+    halfEdges[secondEdge] = firstEdge;
+  }
+}
+
+size_t Delaunay::addTriangle(size_t first, size_t second, size_t third, size_t firstEdge, size_t secondEdge,
+                             size_t thirdEdge) {
+  size_t triangle = triangles.size();
+  triangles.push_back(first);
+  triangles.push_back(second);
+  triangles.push_back(third);
+  halfEdges.resize(triangle + 3);
+  link(triangle, firstEdge);
+  link(triangle + 1, secondEdge);
+  link(triangle + 2, thirdEdge);
+  return triangle;
+}
+
+size_t Delaunay::legalize(size_t edge) {
+  size_t a = edge, ar;
+  edgeStack.clear();
+
+  while (true) {
+    size_t b = halfEdges[a];
+    size_t a0 = a - a % 3;
+    ar = a0 + (a + 2) % 3;
+
+    if (b == none) {
+      if (edgeStack.empty()) {
+        break;
+      }
+      a = edgeStack.back();
+      edgeStack.pop_back();
+      continue;
+    }
+
+    size_t b0 = b - b % 3;
+    size_t al = a0 + (a + 1) % 3, bl = b0 + (b + 2) % 3;
+    size_t p0 = triangles[ar], pr = triangles[a], pl = triangles[al], p1 = triangles[bl];
+
+    if (isInCircle(xs[p0], ys[p0], xs[pr], ys[pr], xs[pl], ys[pl], xs[p1], ys[p1])) {
+      // Flip the edge shared by the two triangles
+      triangles[a] = p1;
+      triangles[b] = p0;
+
+      size_t hbl = halfEdges[bl];
+      if (hbl == none) {
+        size_t e = hullStart;
+        do {
+          if (hullTriangle[e] == bl) {
+            hullTriangle[e] = a;
+            break;
+          }
+          e = hullPrevious[e];
+        } while (e != hullStart);
+      }
+      link(a, hbl);
+      link(b, halfEdges[ar]);
+      link(ar, bl);
+
+      edgeStack.push_back(b0 + (b + 1) % 3);
+    } else {
+      if (edgeStack.empty()) {
+        break;
+      }
+      a = edgeStack.back();
+      edgeStack.pop_back();
+    }
+  }
+
+  return ar;
+}
+
+void Delaunay::triangulate() {
+  size_t n = xs.size();
+  if (n < 2) {
+    return;
+  }
+
+  double minX = *std::min_element(xs.begin(), xs.end()), maxX = *std::max_element(xs.begin(), xs.end());
+  double minY = *std::min_element(ys.begin(), ys.end()), maxY = *std::max_element(ys.begin(), ys.end());
+  double cx = (minX + maxX) / 2, cy = (minY + maxY) / 2;
+
+  auto squaredDistance = [this](double x, double y, size_t i) {
+    double dx = xs[i] - x, dy = ys[i] - y;
+    return dx * dx + dy * dy;
+  };
+
+  // Seed triangle: point closest to the center, its closest point and the one making the smallest circumcircle
+  size_t i0 = 0, i1 = none, i2 = none;
+  for (size_t i = 1; i < n; ++i) {
+    if (squaredDistance(cx, cy, i) < squaredDistance(cx, cy, i0)) {
+      i0 = i;
+    }
+  }
+  double minDistance = numeric_limits<double>::max();
+  for (size_t i = 0; i < n; ++i) {
+    double distance = squaredDistance(xs[i0], ys[i0], i);
+    if (i != i0 && distance < minDistance && distance > 0) {
+      i1 = i;
+      minDistance = distance;
+    }
+  }
+  if (i1 == none) {
+    return;
+  }
+  double minRadius = numeric_limits<double>::max();
+  for (size_t i = 0; i < n; ++i) {
+    if (i != i0 && i != i1) {
+      double radius = getCircumradius(xs[i0], ys[i0], xs[i1], ys[i1], xs[i], ys[i]);
+      if (radius < minRadius) {
+        i2 = i;
+        minRadius = radius;
+      }
+    }
+  }
+
+  vector<size_t> ids(n);
+  iota(ids.begin(), ids.end(), 0);
+  vector<double> distances(n);
+
+  if (i2 == none) {
+    // All points are on one line, order them along it
+    for (size_t i = 0; i < n; ++i) {
+      distances[i] = xs[i] - xs[i0] != 0 ? xs[i] - xs[i0] : ys[i] - ys[i0];
+    }
+    sort(ids.begin(), ids.end(), [&distances](size_t first, size_t second) {
+      return distances[first] < distances[second];
+    });
+    collinearPath = move(ids);
+    return;
+  }
+
+  if (orient(i0, i1, i2)) {
+    swap(i1, i2);
+  }
+
+  auto center = getCircumcenter(xs[i0], ys[i0], xs[i1], ys[i1], xs[i2], ys[i2]);
+  centerX = center.first;
+  centerY = center.second;
+  for (size_t i = 0; i < n; ++i) {
+    distances[i] = squaredDistance(centerX, centerY, i);
+  }
+  sort(ids.begin(), ids.end(), [&distances](size_t first, size_t second) {
+    return distances[first] < distances[second];
+  });
+
+  hashSize = size_t(std::ceil(std::sqrt(double(n))));
+  hullPrevious.assign(n, none);
+  hullNext.assign(n, none);
+  hullTriangle.assign(n, none);
+  hullHash.assign(hashSize, none);
+
+  hullStart = i0;
+  hullNext[i0] = hullPrevious[i2] = i1;
+  hullNext[i1] = hullPrevious[i0] = i2;
+  hullNext[i2] = hullPrevious[i1] = i0;
+
+  hullTriangle[i0] = 0;
+  hullTriangle[i1] = 1;
+  hullTriangle[i2] = 2;
+
+  hullHash[hashKey(xs[i0], ys[i0])] = i0;
+  hullHash[hashKey(xs[i1], ys[i1])] = i1;
+  hullHash[hashKey(xs[i2], ys[i2])] = i2;
+
+  size_t maxTriangles = 2 * n - 5;
+  triangles.reserve(maxTriangles * 3);
+  halfEdges.reserve(maxTriangles * 3);
+  addTriangle(i0, i1, i2, none, none, none);
+
+  for (auto i:ids) {
+    double x = xs[i], y = ys[i];
+    if (i == i0 || i == i1 || i == i2) {
+      continue;
+    }
+
+    // Find a visible edge of the convex hull using the edge hash
+    size_t start = none;
+    size_t key = hashKey(x, y);
+    for (size_t j = 0; j < hashSize; ++j) {
+      start = hullHash[(key + j) % hashSize];
+      if (start != none && start != hullNext[start]) {
+        break;
+      }
+    }
+
+    start = hullPrevious[start];
+    size_t e = start, q = hullNext[e];
+    while (!orient(x, y, e, q)) {
+      e = q;
+      if (e == start) {
+        e = none;
+        break;
+      }
+      q = hullNext[e];
+    }
+    if (e == none) {
+      continue;
+    }
+
+    // Add the first triangle from the point
+    size_t triangle = addTriangle(e, i, hullNext[e], none, none, hullTriangle[e]);
+    hullTriangle[i] = legalize(triangle + 2);
+    hullTriangle[e] = triangle;
+
+    // Walk forward through the hull, adding more triangles and flipping recursively
+    size_t next = hullNext[e];
+    q = hullNext[next];
+    while (orient(x, y, next, q)) {
+      triangle = addTriangle(next, i, q, hullTriangle[i], none, hullTriangle[next]);
+      hullTriangle[i] = legalize(triangle + 2);
+      hullNext[next] = next;
+      next = q;
+      q = hullNext[next];
+    }
+
+    // Walk backward from the other side, adding more triangles and flipping
+    if (e == start) {
+      q = hullPrevious[e];
+      while (orient(x, y, q, e)) {
+        triangle = addTriangle(q, i, e, none, hullTriangle[e], hullTriangle[q]);
+        legalize(triangle + 2);
+        hullTriangle[q] = triangle;
+        hullNext[e] = e;
+        e = q;
+        q = hullPrevious[e];
+      }
+    }
+
+    hullStart = hullPrevious[i] = e;
+    hullNext[e] = hullPrevious[next] = i;
+    hullNext[i] = next;
+
+    hullHash[hashKey(x, y)] = i;
+    hullHash[hashKey(xs[e], ys[e])] = e;
+  }
+}
+
+vector<pair<size_t, size_t>> Delaunay::getEdges() const {
+  vector<pair<size_t, size_t>> edges;
+  if (!collinearPath.empty()) {
+    for (size_t i = 1; i < collinearPath.size(); ++i) {
+      edges.emplace_back(collinearPath[i - 1], collinearPath[i]);
+    }
+    return edges;
+  }
+
+  // Every inner edge is shared by two half-edges, take it from the one with the larger index
+  for (size_t edge = 0; edge < triangles.size(); ++edge) {
+    if (halfEdges[edge] == none || halfEdges[edge] < edge) {
+      size_t next = edge % 3 == 2 ? edge - 2 : edge + 1;
+      edges.emplace_back(triangles[edge], triangles[next]);
+    }
+  }
+  return edges;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+using std::vector;
+using std::pair;
+
+// Delaunay triangulation of points in the plane by sweeping a convex hull around the seed triangle
+// (the algorithm of the Delaunator library), O(n log n) for the points sort.
+class Delaunay {
+  static constexpr size_t none = size_t(-1);
+
+  vector<double> xs, ys;
+
+  vector<size_t> triangles;
+  vector<size_t> halfEdges;
+
+  double centerX = 0, centerY = 0;
+  size_t hashSize = 0;
+  size_t hullStart = 0;
+  vector<size_t> hullPrevious, hullNext, hullTriangle, hullHash;
+  vector<size_t> edgeStack;
+  vector<size_t> collinearPath;
+
+  [[nodiscard]] size_t hashKey(double x, double y) const;
+
+  [[nodiscard]] bool orient(size_t p, size_t q, size_t r) const;
+
+  [[nodiscard]] bool orient(double px, double py, size_t q, size_t r) const;
+
+  void link(size_t firstEdge, size_t secondEdge);
+
+  size_t addTriangle(size_t first, size_t second, size_t third, size_t firstEdge, size_t secondEdge,
+                     size_t thirdEdge);
+
+  size_t legalize(size_t edge);
+
+  void triangulate();
+
+public:
+  // Predicates are evaluated in doubles, which is exact for integer coordinates up to this: the largest term of
+  // the in-circle test, 12 * 4096^4, is below 2^53. Points of a lattice given by their indices never get edges
+  // crossing or passing through other points, while the rounding of other coordinates can produce both.
+  static constexpr double maxExactCoord = 4096;
+
+  // Point i is (xs[i], ys[i]), points have to be distinct
+  Delaunay(vector<double> xs, vector<double> ys);
+
+  // Unique edges of the triangulation, for collinear points the path through them
+  [[nodiscard]] vector<pair<size_t, size_t>> getEdges() const;
+};
@@ -0,0 +1,13 @@
+#include "DiscTexture.h"
+#include "Node.h"
+
+const sf::Texture &DiscTexture::getTexture() {
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  if (!isDrawn || radius != nodeSettings.radius || color != nodeSettings.color) {
+    Node::drawDiscTexture(texture);
+    isDrawn = true;
+    radius = nodeSettings.radius;
+    color = nodeSettings.color;
+  }
+  return texture.getTexture();
+}
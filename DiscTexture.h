@@ -0,0 +1,18 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// Disc the quads of node discs show, drawn with the radius and colour of the node settings. Whoever draws graphs in a
+// GL context keeps one for all of them, so it is made once per context rather than once per graph, and goes with the
+// context rather than at exit.
+class DiscTexture {
+  sf::RenderTexture texture;
+  bool isDrawn = false;
+  // Settings the disc was drawn with
+  double radius = 0;
+  sf::Color color;
+
+public:
+  // Draws the disc again first if the settings changed since
+  [[nodiscard]] const sf::Texture &getTexture();
+};
@@ -0,0 +1,44 @@
+#include "DisjointSet.h"
+#include <numeric>
+
+using std::iota;
+using std::swap;
+
+void DisjointSet::reset(size_t numberOfElements) {
+  parent.resize(numberOfElements);
+  iota(parent.begin(), parent.end(), 0);
+  setSize.assign(numberOfElements, 1);
+  numberOfSets = numberOfElements;
+}
+
+size_t DisjointSet::find(size_t element) {
+  while (parent[element] != element) {
+    parent[element] = parent[parent[element]];
+    element = parent[element];
+  }
+  return element;
+}
+
+bool DisjointSet::unite(size_t first, size_t second) {
+  first = find(first);
+  second = find(second);
+  if (first == second) {
+    return false;
+  }
+
+  if (setSize[first] < setSize[second]) {
+    swap(first, second);
+  }
+  parent[second] = first;
+  setSize[first] += setSize[second];
+  --numberOfSets;
+  return true;
+}
+
+size_t DisjointSet::getSetSize(size_t element) {
+  return setSize[find(element)];
+}
+
+size_t DisjointSet::getNumberOfSets() const {
+  return numberOfSets;
+}
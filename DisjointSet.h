@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+using std::vector;
+
+// Union-find over node indexes, keeps track of connected components as links are added
+class DisjointSet {
+  vector<size_t> parent;
+  vector<size_t> setSize;
+  size_t numberOfSets = 0;
+
+public:
+  void reset(size_t numberOfElements);
+
+  size_t find(size_t element);
+
+  // Returns false if elements were already in the same set
+  bool unite(size_t first, size_t second);
+
+  size_t getSetSize(size_t element);
+
+  [[nodiscard]] size_t getNumberOfSets() const;
+};
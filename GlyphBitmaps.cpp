@@ -0,0 +1,77 @@
+#include "GlyphBitmaps.h"
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
+using std::runtime_error;
+using std::lock_guard;
+
+GlyphBitmaps::GlyphBitmaps(const char *data, size_t size) {
+  if (FT_Init_FreeType(&library) != 0) {
+    throw runtime_error("Unable to initialize FreeType");
+  }
+  if (FT_New_Memory_Face(library, reinterpret_cast<const FT_Byte *>(data), FT_Long(size), 0, &face) != 0) {
+    FT_Done_FreeType(library);
+    throw runtime_error("Unable to load the font face");
+  }
+  FT_Select_Charmap(face, FT_ENCODING_UNICODE);
+}
+
+GlyphBitmaps::~GlyphBitmaps() {
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+}
+
+void GlyphBitmaps::setSize(unsigned characterSize) const {
+  if (face->size->metrics.x_ppem != characterSize && FT_Set_Pixel_Sizes(face, 0, characterSize) != 0) {
+    throw runtime_error("Unable to set the character size " + std::to_string(characterSize));
+  }
+}
+
+const GlyphBitmaps::Glyph &GlyphBitmaps::getGlyph(uint32_t character, unsigned characterSize) const {
+  lock_guard<mutex> lock(faceMutex);
+  auto found = glyphs.find({characterSize, character});
+  if (found != glyphs.end()) {
+    return found->second;
+  }
+
+  setSize(characterSize);
+  // The flags of sf::Font, so that hinting and therefore shapes and advances are the same
+  if (FT_Load_Char(face, character, FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT) != 0 ||
+      FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0) {
+    throw runtime_error("Unable to load the glyph " + std::to_string(character));
+  }
+  const auto *slot = face->glyph;
+  Glyph glyph;
+  glyph.advance = float(slot->metrics.horiAdvance) / 64;
+  glyph.boundsLeft = float(slot->metrics.horiBearingX) / 64;
+  glyph.boundsTop = -float(slot->metrics.horiBearingY) / 64;
+  glyph.boundsWidth = float(slot->metrics.width) / 64;
+  glyph.boundsHeight = float(slot->metrics.height) / 64;
+  glyph.left = slot->bitmap_left;
+  glyph.top = -slot->bitmap_top;
+  glyph.width = int(slot->bitmap.width);
+  glyph.height = int(slot->bitmap.rows);
+  glyph.coverage.resize(size_t(glyph.width) * size_t(glyph.height));
+  for (int row = 0; row < glyph.height; ++row) {
+    const auto *source = slot->bitmap.buffer + ptrdiff_t(row) * slot->bitmap.pitch;
+    std::copy(source, source + glyph.width, glyph.coverage.begin() + ptrdiff_t(row) * glyph.width);
+  }
+  return glyphs.emplace(pair<unsigned, uint32_t>(characterSize, character), std::move(glyph)).first->second;
+}
+
+float GlyphBitmaps::getKerning(uint32_t first, uint32_t second, unsigned characterSize) const {
+  if (first == 0 || second == 0 || !FT_HAS_KERNING(face)) {
+    return 0;
+  }
+  lock_guard<mutex> lock(faceMutex);
+  setSize(characterSize);
+  FT_Vector kerning;
+  if (FT_Get_Kerning(face, FT_Get_Char_Index(face, first), FT_Get_Char_Index(face, second), FT_KERNING_UNFITTED,
+                     &kerning) != 0) {
+    return 0;
+  }
+  return float(kerning.x) / 64;
+}
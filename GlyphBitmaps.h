@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <utility>
+
+using std::vector;
+using std::map;
+using std::mutex;
+using std::pair;
+
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
+// Glyphs of a font rasterized by FreeType into coverage bitmaps, for drawing text without a GL context. Glyphs are
+// loaded and measured as sf::Font does, so text laid out from them matches sf::Text. Safe to use from many threads.
+class GlyphBitmaps {
+public:
+  struct Glyph {
+    // Offset of the bitmap from the pen on the baseline, y growing down
+    int left = 0, top = 0;
+    int width = 0, height = 0;
+    float advance = 0;
+    // Bounds of the outline as sf::Glyph::bounds
+    float boundsLeft = 0, boundsTop = 0, boundsWidth = 0, boundsHeight = 0;
+    // Coverage of the pixels from 0 to 255, row by row
+    vector<uint8_t> coverage;
+  };
+
+private:
+  FT_LibraryRec_ *library = nullptr;
+  FT_FaceRec_ *face = nullptr;
+  // The face has one current size, so loading goes under the lock; glyphs in a map keep their addresses
+  mutable mutex faceMutex;
+  mutable map<pair<unsigned, uint32_t>, Glyph> glyphs;
+
+  // The face has to be locked
+  void setSize(unsigned characterSize) const;
+
+public:
+  // The font data has to outlive the bitmaps
+  GlyphBitmaps(const char *data, size_t size);
+
+  GlyphBitmaps(const GlyphBitmaps &) = delete;
+
+  GlyphBitmaps &operator=(const GlyphBitmaps &) = delete;
+
+  ~GlyphBitmaps();
+
+  [[nodiscard]] const Glyph &getGlyph(uint32_t character, unsigned characterSize) const;
+
+  [[nodiscard]] float getKerning(uint32_t first, uint32_t second, unsigned characterSize) const;
+};
@@ -3,60 +3,71 @@
 //
 
 #include "Graph.h"
+#include "Delaunay.h"
+#include "MappedFile.h"
+#include "TextIO.h"
 #include <random>
 #include <fstream>
+#include <cmath>
+#include <algorithm>
 
 using std::mt19937;
 using std::uniform_int_distribution;
 using std::random_device;
 using std::to_string;
-using std::make_shared;
+using std::minmax_element;
 using std::ofstream;
 using std::ifstream;
 using std::endl;
+using std::runtime_error;
+using std::shuffle;
+using std::llround;
+using std::partial_sort;
+using std::min;
+using std::max;
+using std::all_of;
+
+Graph::Graph() : Graph(Node::NodeSettings::getNodeSettings().radius) {}
+
+Graph::Graph(double nodeRadius) : nodeRadius(nodeRadius) {}
 
 Graph::~Graph() = default;
 
-void Graph::draw(sf::RenderTarget &target, sf::RenderStates states) const {
-  for (const auto &link:links) {
-    if (!showOnlySubgraph || isLinkInSubgraph(link)) {
-      link.draw(target, states);
-    }
-  }
-  for (const auto &node:nodes) {
-    if (!showOnlySubgraph || isNodeInSubgraph(node)) {
-      node->draw(target, states);
+void Graph::draw(sf::RenderTarget &target, sf::RenderStates states, DiscTexture &discTexture) const {
+  if (!areChunksValid) {
+    if (showOnlySubgraph) {
+      renderChunks.reset(core, visibleNodes, visibleLinks);
+    } else {
+      renderChunks.reset(core);
     }
+    areChunksValid = true;
   }
+  renderChunks.draw(core, target, states, discTexture);
 }
 
-Graph Graph::generatePlanar(size_t numberOfVertices, double maxCoord) {
-  Graph graph;
-  graph.addNRandomNodes(numberOfVertices, maxCoord);
-  graph.addLinksTillConnection();
-  return graph;
-}
-
-bool Graph::isConnected() const {
-  if (!nodes.empty()) {
-    map<shared_ptr<Node>, bool> visited;
-    visit(nodes.front(), visited);
-    for (const auto &node:nodes) {
-      if (!visited[node]) {
-        return false;
-      }
-    }
+void Graph::rasterize(SoftwareRasterizer &rasterizer, size_t numberOfThreads) const {
+  if (showOnlySubgraph) {
+    rasterizer.draw(core, visibleNodes, visibleLinks, numberOfThreads);
+    return;
   }
-  return true;
+  vector<size_t> nodes(core.getNumberOfNodes()), links(core.getNumberOfLinks());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    nodes[i] = i;
+  }
+  for (size_t i = 0; i < links.size(); ++i) {
+    links[i] = i;
+  }
+  rasterizer.draw(core, nodes, links, numberOfThreads);
 }
 
-void Graph::visit(const shared_ptr<Node> &node, map<shared_ptr<Node>, bool> &visited) const {
-  visited[node] = true;
-  for (const auto &adjacentNode:node->adjacentNodes) {
-    if (!visited[adjacentNode]) {
-      visit(adjacentNode, visited);
-    }
+sf::FloatRect Graph::getBounds() const {
+  const auto &xs = core.getXs(), &ys = core.getYs();
+  if (xs.empty()) {
+    return sf::FloatRect();
   }
+  auto[minX, maxX] = minmax_element(xs.begin(), xs.end());
+  auto[minY, maxY] = minmax_element(ys.begin(), ys.end());
+  return sf::FloatRect(float(*minX), float(*minY), float(*maxX - *minX), float(*maxY - *minY));
 }
 
 mt19937 &getEngine() {
@@ -64,98 +75,376 @@ mt19937 &getEngine() {
   return twisterEngine;
 }
 
-void Graph::addNRandomNodes(size_t numberOfVertices, double maxCoord) {
-  auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+Graph Graph::generatePlanar(size_t numberOfVertices, double maxCoord, PlanarLinkSampling linkSampling,
+                            NodePlacement placement) {
+  return generatePlanar(numberOfVertices, maxCoord, Node::NodeSettings::getNodeSettings().radius, getEngine(),
+                        linkSampling, placement);
+}
+
+Graph Graph::generatePlanar(size_t numberOfVertices, double maxCoord, double nodeRadius, mt19937 &engine,
+                            PlanarLinkSampling linkSampling, NodePlacement placement,
+                            AdjacencyStorage adjacencyStorage, JobProgress *progress) {
+  Graph graph(nodeRadius);
+  graph.progress = progress;
+  graph.addNRandomNodes(numberOfVertices, maxCoord, engine, placement, adjacencyStorage);
+  graph.addLinksTillConnection(linkSampling, engine);
+  graph.core.freeze();
+  graph.progress = nullptr;
+  return graph;
+}
+
+Graph Graph::generateDelaunayPlanar(size_t numberOfVertices, double maxCoord, double linkFraction,
+                                    NodePlacement placement) {
+  return generateDelaunayPlanar(numberOfVertices, maxCoord, Node::NodeSettings::getNodeSettings().radius, linkFraction,
+                                getEngine(), placement);
+}
+
+Graph Graph::generateDelaunayPlanar(size_t numberOfVertices, double maxCoord, double nodeRadius,
+                                    double linkFraction, mt19937 &engine, NodePlacement placement,
+                                    AdjacencyStorage adjacencyStorage, JobProgress *progress) {
+  Graph graph(nodeRadius);
+  graph.progress = progress;
+  graph.addNRandomNodes(numberOfVertices, maxCoord, engine, placement, adjacencyStorage);
+  graph.addDelaunayLinks(linkFraction, engine);
+  graph.core.freeze();
+  graph.progress = nullptr;
+  return graph;
+}
+
+bool Graph::isConnected() const {
+  return components.getNumberOfSets() <= 1;
+}
+
+size_t Graph::getNumberOfComponents() const {
+  return components.getNumberOfSets();
+}
+
+// Candidate links of every node go to its nearest neighbours, farther ones rarely pass between the nodes around
+const size_t candidateNeighbours = 16;
+
+// Rings searched around every node when random nodes found no link between components, about a node a cell
+const size_t fallbackRings = 8;
+
+double LinkSamplingStats::getRejectionRate() const {
+  return candidatesTested == 0 ? 0 : double(candidatesRejected) / double(candidatesTested);
+}
+
+double LinkSamplingStats::getIntersectionTestsPerLink() const {
+  auto linksAccepted = candidatesTested - candidatesRejected;
+  return linksAccepted == 0 ? 0 : double(intersectionTests) / double(linksAccepted);
+}
+
+const LinkSamplingStats &Graph::getLinkSamplingStats() const {
+  return linkSamplingStats;
+}
+
+const GraphCore &Graph::getCore() const {
+  return core;
+}
+
+const AdjacencyIndex &Graph::getAdjacency() const {
+  return adjacency;
+}
+
+void Graph::addNRandomNodes(size_t numberOfVertices, double maxCoord, mt19937 &engine, NodePlacement placement,
+                            AdjacencyStorage adjacencyStorage) {
   size_t maximumCanFit = maxCoord / nodeRadius / 4.;
 
   double offset = 2 * maxCoord * nodeRadius / (maxCoord + 4 * nodeRadius) + nodeRadius;
   double spaceLength = offset + nodeRadius;
 
-  vector<vector<bool>> occupied(maximumCanFit);
-  for (auto &row:occupied) {
-    row.resize(maximumCanFit);
+  if (numberOfVertices > maximumCanFit * maximumCanFit) {
+    throw runtime_error("Unable to place " + to_string(numberOfVertices) + " nodes, only " +
+                        to_string(maximumCanFit * maximumCanFit) + " fit");
   }
 
-  uniform_int_distribution distribution(0, int(maximumCanFit - 1));
-  auto &engine = getEngine();
+  core.reserveNodes(core.getNumberOfNodes() + numberOfVertices);
+  if (placement == NodePlacement::Lattice) {
+    for (auto cell:sampleDistinct(maximumCanFit * maximumCanFit, numberOfVertices, engine)) {
+      size_t x = cell % maximumCanFit, y = cell / maximumCanFit;
+      core.addNode(offset + x * spaceLength, offset + y * spaceLength);
+    }
+  } else {
+    // Points spread over the square at this distance are about as many as needed, it shrinks when they are not
+    double side = maxCoord - 2 * offset;
+    double minDistance = max(spaceLength, sqrt(.7 * side * side / double(max(numberOfVertices, size_t(1)))));
+    auto points = samplePoissonDisk(offset, maxCoord - offset, minDistance, engine);
+    while (points.size() < numberOfVertices) {
+      if (minDistance == spaceLength) {
+        throw runtime_error("Unable to spread " + to_string(numberOfVertices) + " nodes, only " +
+                            to_string(points.size()) + " fit");
+      }
+      minDistance = max(spaceLength, minDistance * .9);
+      points = samplePoissonDisk(offset, maxCoord - offset, minDistance, engine);
+    }
 
-  for (int i = 0; i < numberOfVertices; ++i) {
-    int x = distribution(engine), y = distribution(engine);
-    while (occupied[x][y]) {
-      x = distribution(engine);
-      y = distribution(engine);
+    shuffle(points.begin(), points.end(), engine);
+    for (size_t i = 0; i < numberOfVertices; ++i) {
+      core.addNode(points[i].first, points[i].second);
     }
-    auto newNode = make_shared<Node>(i, offset + x * spaceLength, offset + y * spaceLength);
-    nodes.push_back(newNode);
-    occupied[x][y] = true;
   }
 
-  adjacencyMatrix.setDimension(nodes.size());
+  // Planar graphs have at most 3n - 6 links
+  adjacency.reset(core.getNumberOfNodes(), 3 * core.getNumberOfNodes(), adjacencyStorage);
+  components.reset(core.getNumberOfNodes());
+  rebuildSpatialIndex();
+  if (placement == NodePlacement::Lattice) {
+    intersectionKernel.reset(core, nodeRadius, offset, offset, spaceLength);
+  }
 }
 
-void Graph::addLinksTillConnection() {
+void Graph::addLinksTillConnection(PlanarLinkSampling linkSampling, mt19937 &engine) {
+  if (linkSampling == PlanarLinkSampling::RandomPairs) {
+    fillCandidateLinks(candidateNeighbours);
+    while (!isConnected() && addRandomLink(engine)) {}
+    candidateLinks.clear();
+  }
+
+  // Also finishes random pairs when none of their candidates can be linked anymore
   while (!isConnected()) {
-    addRandomLink();
+    if (!addRandomLinkBetweenComponents(engine)) {
+      throw runtime_error("Unable to connect " + to_string(components.getNumberOfSets()) +
+                          " components without crossing");
+    }
+  }
+}
+
+void Graph::fillCandidateLinks(size_t neighboursPerNode) {
+  vector<pair<size_t, size_t>> candidates;
+  vector<pair<double, size_t>> neighbours;
+  auto ringCount = spatialIndex.getRingCount();
+
+  for (GraphCore::NodeId i = 0; i < core.getNumberOfNodes(); ++i) {
+    if (progress != nullptr && i % 4096 == 0) {
+      progress->check();
+    }
+    double x = core.getX(i), y = core.getY(i);
+    neighbours.clear();
+
+    // Nodes of the next ring may be closer than some of the found ones, so one more ring is searched
+    auto lastRing = ringCount;
+    for (size_t ring = 0; ring < ringCount && ring <= lastRing; ++ring) {
+      spatialIndex.forEachNodeInRing(x, y, ring, [&](size_t otherIndex) {
+        if (otherIndex != i) {
+          double dx = core.getX(otherIndex) - x, dy = core.getY(otherIndex) - y;
+          neighbours.emplace_back(dx * dx + dy * dy, otherIndex);
+        }
+      });
+      if (lastRing == ringCount && neighbours.size() >= neighboursPerNode) {
+        lastRing = ring + 1;
+      }
+    }
+
+    auto count = min(neighboursPerNode, neighbours.size());
+    partial_sort(neighbours.begin(), neighbours.begin() + long(count), neighbours.end());
+    for (size_t j = 0; j < count; ++j) {
+      candidates.emplace_back(i, neighbours[j].second);
+    }
+  }
+
+  candidateLinks.fill(move(candidates));
+}
+
+void Graph::addDelaunayLinks(double linkFraction, mt19937 &engine) {
+  // Nodes of a lattice are triangulated by their lattice indices, where the predicates are exact, as the plane
+  // coordinates are nearly all collinear and cocircular and rounding them gives crossing links
+  const auto &columns = intersectionKernel.getColumns(), &rows = intersectionKernel.getRows();
+  bool isOnSmallLattice = intersectionKernel.isExact() &&
+                          all_of(columns.begin(), columns.end(), [](double column) {
+                            return column <= Delaunay::maxExactCoord;
+                          }) &&
+                          all_of(rows.begin(), rows.end(), [](double row) {
+                            return row <= Delaunay::maxExactCoord;
+                          });
+  auto delaunayLinks = isOnSmallLattice ? Delaunay(columns, rows).getEdges() :
+                       Delaunay(core.getXs(), core.getYs()).getEdges();
+  shuffle(delaunayLinks.begin(), delaunayLinks.end(), engine);
+
+  // Links of an exact triangulation never cross, but may touch the disc of a node lying close to them, so they are
+  // still checked
+  vector<pair<size_t, size_t>> otherLinks;
+  for (const auto &[firstNodeIndex, secondNodeIndex]:delaunayLinks) {
+    if (components.find(firstNodeIndex) != components.find(secondNodeIndex)) {
+      if (canAddLinkBetween(firstNodeIndex, secondNodeIndex)) {
+        addLink(firstNodeIndex, secondNodeIndex);
+      }
+    } else {
+      otherLinks.emplace_back(firstNodeIndex, secondNodeIndex);
+    }
+  }
+
+  auto numberOfLinks = size_t(max(0ll, llround(linkFraction * double(delaunayLinks.size()))));
+  for (const auto &[firstNodeIndex, secondNodeIndex]:otherLinks) {
+    if (core.getNumberOfLinks() >= numberOfLinks) {
+      break;
+    }
+    if (canAddLinkBetween(firstNodeIndex, secondNodeIndex)) {
+      addLink(firstNodeIndex, secondNodeIndex);
+    }
   }
+
+  addLinksTillConnection(PlanarLinkSampling::BetweenComponents, engine);
 }
 
 bool Graph::canAddLinkBetween(size_t firstNodeIndex, size_t secondNodeIndex) const {
-  if (firstNodeIndex == secondNodeIndex) {
+  ++linkSamplingStats.candidatesTested;
+
+  if (firstNodeIndex == secondNodeIndex || adjacency.areAdjacent(firstNodeIndex, secondNodeIndex)) {
+    ++linkSamplingStats.candidatesRejected;
     return false;
   }
 
-  if (firstNodeIndex > secondNodeIndex) {
-    if (adjacencyMatrix.at(firstNodeIndex, secondNodeIndex)) {
-      return false;
+  auto query = intersectionKernel.makeQuery(core, firstNodeIndex, secondNodeIndex);
+  const auto &link = query.link;
+
+  // Only the cells along the link are checked, column by column, and the first obstacle in any of them rejects the
+  // candidate
+  auto &intersectionTests = linkSamplingStats.intersectionTests;
+  if (spatialIndex.anyAlong(link.x1, link.y1, link.x2, link.y2, nodeRadius, [&](const vector<size_t> &nodeIndexes) {
+    return intersectionKernel.anyNodeTouches(core, query, nodeIndexes, intersectionTests);
+  }, [&](const vector<size_t> &linkIndexes) {
+    return intersectionKernel.anyLinkCrosses(core, query, linkIndexes, intersectionTests);
+  })) {
+    ++linkSamplingStats.candidatesRejected;
+    return false;
+  }
+  return true;
+}
+
+bool Graph::addRandomLink(mt19937 &engine) {
+  // Rejected candidates are dropped for good: adjacent nodes stay adjacent and crossed links stay in place
+  while (!candidateLinks.empty()) {
+    auto[firstNodeIndex, secondNodeIndex] = candidateLinks.take(engine);
+    if (canAddLinkBetween(firstNodeIndex, secondNodeIndex)) {
+      addLink(firstNodeIndex, secondNodeIndex);
+      return true;
     }
-  } else {
-    if (adjacencyMatrix.at(secondNodeIndex, firstNodeIndex)) {
-      return false;
+  }
+  return false;
+}
+
+bool Graph::addRandomLinkBetweenComponents(mt19937 &engine) {
+  auto numberOfNodes = core.getNumberOfNodes();
+  uniform_int_distribution distribution(0, int(numberOfNodes - 1));
+
+  // Nearest node of other component is much closer to a node of a small component than to one of the largest.
+  // Nodes enclosed by links of other components give up early as only a few of their candidates are reachable.
+  for (int attempt = 0; attempt < 16; ++attempt) {
+    size_t nodeIndex = distribution(engine);
+    while (components.getSetSize(nodeIndex) * 2 > numberOfNodes) {
+      nodeIndex = distribution(engine);
+    }
+    if (addLinkToOtherComponent(nodeIndex, 16, spatialIndex.getRingCount())) {
+      return true;
     }
   }
 
-  const auto &firstNode = nodes[firstNodeIndex], &secondNode = nodes[secondNodeIndex];
-  Link link(firstNode, secondNode);
-  for (const auto &otherLink:links) {
-    if (link.doIntersect(otherLink)) {
-      return false;
+  // Every link between components has an end outside the largest one. Searching a few rings around each of those
+  // ends keeps the fallback linear in the number of nodes.
+  size_t largestNode = 0;
+  for (size_t i = 1; i < numberOfNodes; ++i) {
+    if (components.getSetSize(i) > components.getSetSize(largestNode)) {
+      largestNode = i;
     }
   }
-  for (const auto &node:nodes) {
-    if (node != firstNode && node != secondNode) {
-      if (link.doIntersect(*node)) {
+  auto largestComponent = components.find(largestNode);
+  for (size_t i = 0; i < numberOfNodes; ++i) {
+    if (components.find(i) != largestComponent && addLinkToOtherComponent(i, numberOfNodes, fallbackRings)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Graph::addLinkToOtherComponent(size_t nodeIndex, size_t maxCandidates, size_t maxRings) {
+  double x = core.getX(nodeIndex), y = core.getY(nodeIndex);
+  auto component = components.find(nodeIndex);
+
+  vector<size_t> candidates;
+  for (size_t ring = 0; ring < min(maxRings, spatialIndex.getRingCount()); ++ring) {
+    candidates.clear();
+    spatialIndex.forEachNodeInRing(x, y, ring, [&](size_t otherIndex) {
+      if (components.find(otherIndex) != component) {
+        candidates.push_back(otherIndex);
+      }
+    });
+
+    auto distance = [this, x, y](size_t otherIndex) {
+      double dx = core.getX(otherIndex) - x, dy = core.getY(otherIndex) - y;
+      return dx * dx + dy * dy;
+    };
+    sort(candidates.begin(), candidates.end(), [&distance](size_t first, size_t second) {
+      return distance(first) < distance(second);
+    });
+
+    for (auto candidate:candidates) {
+      if (canAddLinkBetween(nodeIndex, candidate)) {
+        addLink(nodeIndex, candidate);
+        return true;
+      }
+      if (--maxCandidates == 0) {
         return false;
       }
     }
   }
-  return true;
+  return false;
+}
+
+void Graph::addLink(size_t firstNodeIndex, size_t secondNodeIndex) {
+  auto linkIndex = core.addLink(firstNodeIndex, secondNodeIndex);
+  areChunksValid = false;
+  adjacency.addLink(firstNodeIndex, secondNodeIndex);
+  components.unite(firstNodeIndex, secondNodeIndex);
+  if (!spatialIndex.empty()) {
+    spatialIndex.insertLink(linkIndex, core.getX(firstNodeIndex), core.getY(firstNodeIndex),
+                            core.getX(secondNodeIndex), core.getY(secondNodeIndex));
+  }
+  // Generators link nodes till they are connected, so the progress is the share of components merged
+  if (progress != nullptr) {
+    auto numberOfNodes = core.getNumberOfNodes();
+    progress->report(double(numberOfNodes - components.getNumberOfSets()) / double(max(numberOfNodes, size_t(2)) - 1));
+  }
+}
+
+bool Graph::needsRedraw() const {
+  return !areChunksValid || renderChunks.isStale();
 }
 
-void Graph::addRandomLink() {
-  uniform_int_distribution distribution(0, int(nodes.size() - 1));
-  auto &engine = getEngine();
+void Graph::rebuildSpatialIndex() {
+  intersectionKernel.reset(nodeRadius);
 
-  int firstNodeIndex = distribution(engine), secondNodeIndex = distribution(engine);
-  while (!canAddLinkBetween(firstNodeIndex, secondNodeIndex)) {
-    firstNodeIndex = distribution(engine);
-    secondNodeIndex = distribution(engine);
+  auto numberOfNodes = core.getNumberOfNodes();
+  if (numberOfNodes == 0) {
+    spatialIndex.clear();
+    return;
   }
 
-  const auto &firstNode = nodes[firstNodeIndex], &secondNode = nodes[secondNodeIndex];
-  firstNode->adjacentNodes.push_back(secondNode);
-  secondNode->adjacentNodes.push_back(firstNode);
+  const auto &xs = core.getXs(), &ys = core.getYs();
+  auto[minX, maxX] = minmax_element(xs.begin(), xs.end());
+  auto[minY, maxY] = minmax_element(ys.begin(), ys.end());
+
+  // About one node per cell
+  double side = max({*maxX - *minX, *maxY - *minY, 1.});
+  spatialIndex.reset(*minX, *minY, *maxX, *maxY, side / ceil(sqrt(double(numberOfNodes))));
 
-  addLink(firstNodeIndex, secondNodeIndex);
+  for (size_t i = 0; i < numberOfNodes; ++i) {
+    spatialIndex.insertNode(i, xs[i], ys[i]);
+  }
+  for (size_t i = 0; i < core.getNumberOfLinks(); ++i) {
+    auto[firstNodeIndex, secondNodeIndex] = core.getLink(i);
+    spatialIndex.insertLink(i, xs[firstNodeIndex], ys[firstNodeIndex], xs[secondNodeIndex], ys[secondNodeIndex]);
+  }
 }
 
-void Graph::addLink(size_t firstNodeIndex, size_t secondNodeIndex) {
-  const auto &firstNode = nodes[firstNodeIndex], &secondNode = nodes[secondNodeIndex];
-  links.emplace_back(firstNode, secondNode);
-  if (firstNodeIndex > secondNodeIndex) {
-    adjacencyMatrix.at(firstNodeIndex, secondNodeIndex) = true;
-  } else {
-    adjacencyMatrix.at(secondNodeIndex, firstNodeIndex) = true;
+void Graph::rebuildIndexes(AdjacencyStorage adjacencyStorage) {
+  areChunksValid = false;
+  adjacency.reset(core.getNumberOfNodes(), core.getNumberOfLinks(), adjacencyStorage);
+  components.reset(core.getNumberOfNodes());
+  for (const auto &[firstNodeIndex, secondNodeIndex]:core.getLinks()) {
+    adjacency.addLink(firstNodeIndex, secondNodeIndex);
+    components.unite(firstNodeIndex, secondNodeIndex);
   }
+  rebuildSpatialIndex();
 }
 
 string toString(const list<size_t> &mList) {
@@ -171,9 +460,9 @@ string toString(const list<size_t> &mList) {
   }
 }
 
-shared_ptr<Node> getNodeOfCombinationTree(size_t numberOfNodes, size_t numberOfLayers, const list<size_t> &nodeList) {
-  auto newNode = make_shared<Node>(0, 0, 0);
-  newNode->name = toString(nodeList);
+// Adds the subtrees of children of nodeList to the core, every child right after the subtree of the previous one
+void addCombinationTreeChildren(GraphCore &core, GraphCore::NodeId parent, size_t numberOfNodes,
+                                size_t numberOfLayers, const list<size_t> &nodeList, JobProgress *progress) {
   if (nodeList.size() != numberOfLayers) {
     auto newNodeList = nodeList;
     if (nodeList.empty()) {
@@ -181,139 +470,217 @@ shared_ptr<Node> getNodeOfCombinationTree(size_t numberOfNodes, size_t numberOfL
     } else {
       newNodeList.push_back(nodeList.back() + 1);
     }
-    newNode->adjacentNodes.push_back(getNodeOfCombinationTree(numberOfNodes, numberOfLayers, newNodeList));
-    while (newNodeList.back() < numberOfNodes - numberOfLayers + nodeList.size() + 1) {
+    while (true) {
+      auto child = core.addNode(0, 0, toString(newNodeList));
+      core.addLink(parent, child);
+      addCombinationTreeChildren(core, child, numberOfNodes, numberOfLayers, newNodeList, progress);
+      // Subtrees of the children of the root are told apart by their first number
+      if (progress != nullptr) {
+        if (nodeList.empty()) {
+          progress->report(double(newNodeList.back()) / double(numberOfNodes - numberOfLayers + 1));
+        } else {
+          progress->check();
+        }
+      }
+      if (newNodeList.back() >= numberOfNodes - numberOfLayers + nodeList.size() + 1) {
+        break;
+      }
       ++newNodeList.back();
-      newNode->adjacentNodes.push_back(getNodeOfCombinationTree(numberOfNodes, numberOfLayers, newNodeList));
     }
   }
-
-  return newNode;
 }
 
-size_t getNumberOfLeaves(const shared_ptr<Node> &root) {
-  size_t result = 1;
-  for (const auto &adjacentNode:root->adjacentNodes) {
-    result += getNumberOfLeaves(adjacentNode);
-  }
-  return result;
-}
-
-size_t getTreeWidth(const shared_ptr<Node> &root) {
-  if (root->adjacentNodes.empty()) {
-    return 1;
-  } else {
-    size_t result = 0;
-    for (const auto &adjacentNode:root->adjacentNodes) {
-      result += getTreeWidth(adjacentNode);
+// Children of a tree node are its neighbours with larger ids, as every node is added after its parent
+template<typename Function>
+void forEachChild(const GraphCore &core, GraphCore::NodeId node, Function function) {
+  for (auto adjacentNode:core.getNeighbours(node)) {
+    if (adjacentNode > node) {
+      function(adjacentNode);
     }
-    return result;
   }
 }
 
-double fixX(const shared_ptr<Node> &root, double offset, double spaceLength, double radius) {
-  if (root->adjacentNodes.empty()) {
-    root->x = offset + radius;
+double fixX(GraphCore &core, GraphCore::NodeId root, double offset, double spaceLength, double radius) {
+  if (core.getDegree(root) == (root == 0 ? 0 : 1)) {
+    core.setX(root, offset + radius);
     return radius * 2;
   } else {
     double treeOffset = 0;
-    for (const auto &adjacentNode : root->adjacentNodes) {
-      treeOffset += fixX(adjacentNode, offset + treeOffset, spaceLength, radius) + spaceLength;
-    }
+    forEachChild(core, root, [&](GraphCore::NodeId child) {
+      treeOffset += fixX(core, child, offset + treeOffset, spaceLength, radius) + spaceLength;
+    });
     treeOffset -= spaceLength;
-    root->x = offset + treeOffset / 2.;
+    core.setX(root, offset + treeOffset / 2.);
     return treeOffset;
   }
 }
 
-void fixY(const shared_ptr<Node> &root, double spaceLength, double radius, size_t layer) {
-  root->y = spaceLength + radius + layer * (spaceLength + radius * 2);
-  for (const auto &adjacentNode:root->adjacentNodes) {
-    fixY(adjacentNode, spaceLength, radius, layer + 1);
-  }
+void fixY(GraphCore &core, GraphCore::NodeId root, double spaceLength, double radius, size_t layer) {
+  core.setY(root, spaceLength + radius + layer * (spaceLength + radius * 2));
+  forEachChild(core, root, [&](GraphCore::NodeId child) {
+    fixY(core, child, spaceLength, radius, layer + 1);
+  });
 }
 
-Graph Graph::generateCombinationTree(size_t numberOfNodes, size_t numberOfLayers, double maxCoord) {
-  auto treeRoot = getNodeOfCombinationTree(numberOfNodes, numberOfLayers, list<size_t>());
-  auto treeWidth = getTreeWidth(treeRoot);
-
-  double radius = Node::NodeSettings::getNodeSettings().radius;
-  double spaceLength = (maxCoord - 2. * radius * treeWidth) / (treeWidth + 1.);
-  fixX(treeRoot, spaceLength, spaceLength, radius);
+Graph Graph::generateCombinationTree(size_t numberOfNodes, size_t numberOfLayers, double maxCoord,
+                                     double nodeRadius, JobProgress *progress) {
+  Graph graph(nodeRadius);
+  auto &core = graph.core;
+  auto treeRoot = core.addNode(0, 0, toString(list<size_t>()));
+  addCombinationTreeChildren(core, treeRoot, numberOfNodes, numberOfLayers, list<size_t>(), progress);
+  core.freeze();
+
+  size_t treeWidth = 0;
+  for (GraphCore::NodeId i = 0; i < core.getNumberOfNodes(); ++i) {
+    if (core.getDegree(i) == (i == treeRoot ? 0 : 1)) {
+      ++treeWidth;
+    }
+  }
 
-  spaceLength = (maxCoord - 2. * radius * (numberOfLayers + 1.)) / (numberOfLayers + 2.);
-  fixY(treeRoot, spaceLength, radius, 0);
+  double spaceLength = (maxCoord - 2. * nodeRadius * treeWidth) / (treeWidth + 1.);
+  fixX(core, treeRoot, spaceLength, spaceLength, nodeRadius);
 
-  Graph graph;
-  graph.adjacencyMatrix.setDimension(getNumberOfLeaves(treeRoot));
-  graph.nodes.push_back(treeRoot);
-  graph.fromTree(treeRoot, 0);
+  spaceLength = (maxCoord - 2. * nodeRadius * (numberOfLayers + 1.)) / (numberOfLayers + 2.);
+  fixY(core, treeRoot, spaceLength, nodeRadius, 0);
 
+  graph.rebuildIndexes();
   return graph;
 }
 
-void Graph::fromTree(const shared_ptr<Node> &root, size_t rootIndex) {
-  for (const auto &adjacentNode:root->adjacentNodes) {
-    size_t elementIndex = nodes.size();
-    nodes.push_back(adjacentNode);
-    adjacentNode->id = elementIndex;
-    addLink(rootIndex, elementIndex);
-    fromTree(adjacentNode, elementIndex);
+void Graph::exportVectorImage(ostream &out, VectorFormat format) const {
+  if (showOnlySubgraph) {
+    writeVectorImage(out, core, &visibleNodes, &visibleLinks, format);
+  } else {
+    writeVectorImage(out, core, nullptr, nullptr, format);
+  }
+}
+
+void Graph::exportTiledImage(ostream &out, const TiledImageSettings &settings, RenderBackend backend) const {
+  const auto *nodes = showOnlySubgraph ? &visibleNodes : nullptr;
+  const auto *links = showOnlySubgraph ? &visibleLinks : nullptr;
+  auto area = getImageArea(core, nodes);
+  if (backend == RenderBackend::Software) {
+    writeTiledPng(out, core, nodes, links, area, settings);
+  } else {
+    // All tiles are drawn in one context, with one disc texture
+    DiscTexture discTexture;
+    writeTiledPng(out, [&](sf::RenderTarget &target) {
+      draw(target, sf::RenderStates::Default, discTexture);
+    }, area, settings);
   }
 }
 
-void Graph::save(const string &name) const {
+void Graph::save(const string &name, GraphFileFormat format) const {
+  if (format == GraphFileFormat::Binary) {
+    ofstream out("graphs/" + name, std::ios::binary);
+    writeGraphFile(out, core, adjacency.getMatrix());
+    return;
+  }
+  if (format == GraphFileFormat::EdgeList) {
+    ofstream out("edges/" + name);
+    writeEdgeListText(out, core);
+    return;
+  }
+
   ofstream matrixOut("matrix/" + name);
-  adjacencyMatrix.writeToStreamFull(matrixOut);
+  writeMatrixText(matrixOut, core);
   ofstream nodesOut("nodes/" + name);
-  nodesOut << nodes.size() << endl;
-  for (const auto &node:nodes) {
-    nodesOut << node->x << " " << node->y << " " << node->name << endl;
-  }
+  writeNodesText(nodesOut, core);
 }
 
-void Graph::load(const string &name) {
+void Graph::load(const string &name, GraphFileFormat format, AdjacencyStorage adjacencyStorage,
+                 JobProgress *progress) {
+  if (format == GraphFileFormat::Binary) {
+    MappedFile file("graphs/" + name);
+    showFullGraph();
+    core = readGraphFile(file.data(), file.size());
+    core.freeze();
+    rebuildIndexes(adjacencyStorage);
+    return;
+  }
+  if (format == GraphFileFormat::EdgeList) {
+    ifstream in("edges/" + name);
+    if (!in) {
+      throw runtime_error("Unable to open edges/" + name);
+    }
+    loadEdgeList(in, adjacencyStorage, progress);
+    return;
+  }
+
   ifstream matrixIn("matrix/" + name);
   ifstream nodesIn("nodes/" + name);
-  load(matrixIn, nodesIn);
+  load(matrixIn, nodesIn, adjacencyStorage, progress);
 }
 
 void Graph::showSubgraph(const vector<size_t> &newSubgraph) {
+  // Ids of nodes the graph does not have are ignored
+  subgraph.assign(core.getNumberOfNodes(), false);
+  for (auto nodeIndex:newSubgraph) {
+    if (nodeIndex < subgraph.size()) {
+      subgraph[nodeIndex] = true;
+    }
+  }
+
+  visibleNodes.clear();
+  for (size_t i = 0; i < subgraph.size(); ++i) {
+    if (subgraph[i]) {
+      visibleNodes.push_back(i);
+    }
+  }
+  visibleLinks.clear();
+  for (size_t i = 0; i < core.getNumberOfLinks(); ++i) {
+    auto[firstNodeIndex, secondNodeIndex] = core.getLink(i);
+    if (isLinkInSubgraph(firstNodeIndex, secondNodeIndex)) {
+      visibleLinks.push_back(i);
+    }
+  }
   showOnlySubgraph = true;
-  subgraph = newSubgraph;
+  areChunksValid = false;
 }
 
 void Graph::showFullGraph() {
   showOnlySubgraph = false;
+  areChunksValid = false;
+  subgraph.clear();
+  visibleNodes.clear();
+  visibleLinks.clear();
 }
 
-bool Graph::isNodeInSubgraph(shared_ptr<Node> node) const {
-  return find(subgraph.begin(), subgraph.end(), node->id) != subgraph.end();
+bool Graph::isNodeInSubgraph(size_t nodeIndex) const {
+  return nodeIndex < subgraph.size() && subgraph[nodeIndex];
 }
 
-bool Graph::isLinkInSubgraph(const Link &link) const {
-  return isNodeInSubgraph(link.first) && isNodeInSubgraph(link.second);
+bool Graph::isLinkInSubgraph(size_t firstNodeIndex, size_t secondNodeIndex) const {
+  return isNodeInSubgraph(firstNodeIndex) && isNodeInSubgraph(secondNodeIndex);
 }
 
-void Graph::load(istream &matrixIn, istream &nodesIn) {
-  adjacencyMatrix.readFromStreamFull(matrixIn);
+void Graph::load(istream &matrixIn, istream &nodesIn, AdjacencyStorage adjacencyStorage, JobProgress *progress) {
+  showFullGraph();
+  core.clear();
+  // Links are collected first, so the adjacency storage is chosen knowing their number
+  auto matrix = readMatrixText(matrixIn, progress);
+  adjacency.reset(matrix.numberOfNodes, matrix.links.size(), adjacencyStorage);
+  components.reset(matrix.numberOfNodes);
+  readNodesText(nodesIn, core);
+  if (core.getNumberOfNodes() != matrix.numberOfNodes) {
+    throw runtime_error("Matrix of " + to_string(matrix.numberOfNodes) + " nodes does not match the " +
+                        to_string(core.getNumberOfNodes()) + " nodes of the nodes file");
+  }
 
-  size_t n;
-  nodesIn >> n;
-  for (size_t i = 0; i < n; ++i) {
-    double x, y;
-    nodesIn >> x >> y;
-    auto node = make_shared<Node>(i, x, y);
-    if (nodesIn.get() != '\n') {
-      getline(nodesIn, node->name);
-    }
-    nodes.push_back(node);
-    for (size_t j = 0; j < i; ++j) {
-      if (adjacencyMatrix.at(i, j)) {
-        node->adjacentNodes.push_back(nodes[j]);
-        nodes[j]->adjacentNodes.push_back(node);
-        links.emplace_back(node, nodes[j]);
-      }
-    }
+  core.reserveLinks(matrix.links.size());
+  for (const auto &[i, j]:matrix.links) {
+    adjacency.addLink(i, j);
+    core.addLink(i, j);
+    components.unite(i, j);
   }
+  core.freeze();
+  rebuildSpatialIndex();
+}
+
+void Graph::loadEdgeList(istream &in, AdjacencyStorage adjacencyStorage, JobProgress *progress) {
+  showFullGraph();
+  core.clear();
+  readEdgeListText(in, core, 4 * nodeRadius, progress);
+  core.freeze();
+  rebuildIndexes(adjacencyStorage);
 }
@@ -4,55 +4,176 @@
 #pragma once
 
 #include "Link.h"
-#include "TriangleBoolSquareMatrix.h"
+#include "GraphCore.h"
+#include "AdjacencyIndex.h"
+#include "SpatialGrid.h"
+#include "IntersectionKernel.h"
+#include "DisjointSet.h"
+#include "CandidateEdgeSampler.h"
+#include "NodePlacement.h"
+#include "GraphFile.h"
+#include "JobProgress.h"
+#include "RenderChunks.h"
+#include "SoftwareRasterizer.h"
+#include "VectorExport.h"
+#include "TiledImageExport.h"
 #include <list>
+#include <random>
 
-using std::map;
 using std::ifstream;
 using std::list;
 
-class Graph : public sf::Drawable {
-  vector<shared_ptr<Node>> nodes;
-  vector<Link> links;
-  TriangleBoolSquareMatrix adjacencyMatrix;
+enum class PlanarLinkSampling {
+  // Links between random pairs of nearby nodes drawn from a pool of candidates
+  RandomPairs,
+  // Links from a random node to the nearest nodes of other components
+  BetweenComponents
+};
+
+// Counters of link candidates checked while generating planar graphs
+struct LinkSamplingStats {
+  size_t candidatesTested = 0;
+  size_t candidatesRejected = 0;
+  // Links and nodes tested against candidates, up to the first one in the way
+  size_t intersectionTests = 0;
+
+  [[nodiscard]] double getRejectionRate() const;
+
+  [[nodiscard]] double getIntersectionTestsPerLink() const;
+};
+
+class Graph {
+  GraphCore core;
+  AdjacencyIndex adjacency;
+  SpatialGrid spatialIndex;
+  IntersectionKernel intersectionKernel;
+  DisjointSet components;
+  CandidateEdgeSampler candidateLinks;
+  mutable LinkSamplingStats linkSamplingStats;
 
   bool showOnlySubgraph = false;
-  vector<size_t> subgraph;
+  // Selected nodes by id, and the nodes and links drawn while the selection is shown
+  vector<bool> subgraph;
+  vector<size_t> visibleNodes, visibleLinks;
 
-  void visit(const shared_ptr<Node> &node, map<shared_ptr<Node>, bool> &visited) const;
+  // Drawn nodes and links, split again on the first draw after the graph or the selection change
+  mutable RenderChunks renderChunks;
+  mutable bool areChunksValid = false;
 
-  void addNRandomNodes(size_t numberOfVertices, double maxCoord);
+  // Progress of the generator building the graph, if it reports any
+  JobProgress *progress = nullptr;
 
-  void addLinksTillConnection();
+  // Radius nodes are spaced by and links keep clear of while the graph is built, fixed when it is made, so building
+  // on a worker thread never reads the settings the interface changes
+  double nodeRadius;
+
+  void addNRandomNodes(size_t numberOfVertices, double maxCoord, mt19937 &engine, NodePlacement placement,
+                       AdjacencyStorage adjacencyStorage);
+
+  void addLinksTillConnection(PlanarLinkSampling linkSampling, mt19937 &engine);
+
+  void addDelaunayLinks(double linkFraction, mt19937 &engine);
 
   [[nodiscard]] bool canAddLinkBetween(size_t firstNodeIndex, size_t secondNodeIndex) const;
 
-  void addRandomLink();
+  void fillCandidateLinks(size_t neighboursPerNode);
+
+  [[nodiscard]] bool addRandomLink(mt19937 &engine);
+
+  [[nodiscard]] bool addRandomLinkBetweenComponents(mt19937 &engine);
+
+  // Links the node to the nearest node of another component it can reach, trying at most maxCandidates of them in at
+  // most maxRings rings of the spatial index around it
+  [[nodiscard]] bool addLinkToOtherComponent(size_t nodeIndex, size_t maxCandidates, size_t maxRings);
 
   void addLink(size_t firstNodeIndex, size_t secondNodeIndex);
 
-  void fromTree(const shared_ptr<Node> &root, size_t rootIndex);
+  void rebuildSpatialIndex();
 
-  [[nodiscard]] bool isNodeInSubgraph(shared_ptr<Node> node) const;
+  // Matrix, components and spatial index of links added to the core directly
+  void rebuildIndexes(AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic);
 
-  [[nodiscard]] bool isLinkInSubgraph(const Link &link) const;
+  [[nodiscard]] bool isNodeInSubgraph(size_t nodeIndex) const;
+
+  [[nodiscard]] bool isLinkInSubgraph(size_t firstNodeIndex, size_t secondNodeIndex) const;
 
 public:
-  ~Graph() override;
+  // With the radius of the node settings, read on the calling thread
+  Graph();
+
+  explicit Graph(double nodeRadius);
+
+  Graph(Graph &&other) = default;
+
+  Graph &operator=(Graph &&other) = default;
+
+  ~Graph();
+
+  // The disc texture is the one kept for the GL context of the target
+  void draw(sf::RenderTarget &target, sf::RenderStates states, DiscTexture &discTexture) const;
 
-  void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+  // Draws what draw() would through the view of the rasterizer, without a GL context
+  void rasterize(SoftwareRasterizer &rasterizer, size_t numberOfThreads = 1) const;
+
+  // Whether the graph, the selection or the settings it is drawn with changed since the last draw
+  [[nodiscard]] bool needsRedraw() const;
+
+  // Smallest rectangle holding the centres of all nodes
+  [[nodiscard]] sf::FloatRect getBounds() const;
 
   [[nodiscard]] bool isConnected() const;
 
-  static Graph generatePlanar(size_t numberOfVertices, double maxCoord);
+  [[nodiscard]] size_t getNumberOfComponents() const;
+
+  [[nodiscard]] const LinkSamplingStats &getLinkSamplingStats() const;
+
+  [[nodiscard]] const GraphCore &getCore() const;
+
+  [[nodiscard]] const AdjacencyIndex &getAdjacency() const;
+
+  // Generators without an engine share one seeded from random_device, so they must not run concurrently. They take
+  // the radius of the node settings, the others the given one.
+  static Graph generatePlanar(size_t numberOfVertices, double maxCoord,
+                              PlanarLinkSampling linkSampling = PlanarLinkSampling::RandomPairs,
+                              NodePlacement placement = NodePlacement::Lattice);
+
+  static Graph generatePlanar(size_t numberOfVertices, double maxCoord, double nodeRadius, mt19937 &engine,
+                              PlanarLinkSampling linkSampling = PlanarLinkSampling::RandomPairs,
+                              NodePlacement placement = NodePlacement::Lattice,
+                              AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic,
+                              JobProgress *progress = nullptr);
+
+  // Random spanning tree of the Delaunay triangulation of random nodes plus linkFraction of the triangulation links
+  static Graph generateDelaunayPlanar(size_t numberOfVertices, double maxCoord, double linkFraction,
+                                      NodePlacement placement = NodePlacement::Lattice);
+
+  static Graph generateDelaunayPlanar(size_t numberOfVertices, double maxCoord, double nodeRadius, double linkFraction,
+                                      mt19937 &engine, NodePlacement placement = NodePlacement::Lattice,
+                                      AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic,
+                                      JobProgress *progress = nullptr);
+
+  static Graph generateCombinationTree(size_t numberOfNodes, size_t numberOfLayers, double maxCoord, double nodeRadius,
+                                       JobProgress *progress = nullptr);
+
+  void save(const string &name, GraphFileFormat format = GraphFileFormat::Text) const;
+
+  // Streams the shown graph, the selection if one is shown, as a vector image
+  void exportVectorImage(ostream &out, VectorFormat format) const;
 
-  static Graph generateCombinationTree(size_t numberOfNodes, size_t numberOfLayers, double maxCoord);
+  // Streams the shown graph as a PNG of any size drawn in tiles, the GL backend drawing them through draw()
+  void exportTiledImage(ostream &out, const TiledImageSettings &settings, RenderBackend backend) const;
 
-  void save(const string &name) const;
+  // Progress is reported while reading a text matrix, edge lists only check for cancellation. Loaders keep the node
+  // radius of the graph.
+  void load(const string &name, GraphFileFormat format = GraphFileFormat::Text,
+            AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic, JobProgress *progress = nullptr);
 
-  void load(const string &name);
+  void load(istream &matrixIn, istream &nodesIn, AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic,
+            JobProgress *progress = nullptr);
 
-  void load(istream &matrixIn, istream &nodesIn);
+  // Reads the links in one pass, the adjacency storage is chosen once their number is known
+  void loadEdgeList(istream &in, AdjacencyStorage adjacencyStorage = AdjacencyStorage::Automatic,
+                    JobProgress *progress = nullptr);
 
   void showSubgraph(const vector<size_t> &newSubgraph);
 
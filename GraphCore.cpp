@@ -0,0 +1,186 @@
+#include "GraphCore.h"
+#include <stdexcept>
+
+using std::move;
+using std::to_string;
+using std::runtime_error;
+
+const GraphCore::NodeId *GraphCore::Neighbours::begin() const {
+  return first;
+}
+
+const GraphCore::NodeId *GraphCore::Neighbours::end() const {
+  return last;
+}
+
+size_t GraphCore::Neighbours::size() const {
+  return size_t(last - first);
+}
+
+bool GraphCore::Neighbours::empty() const {
+  return first == last;
+}
+
+void GraphCore::clear() {
+  xs.clear();
+  ys.clear();
+  names.clear();
+  links.clear();
+  frozen = false;
+  adjacencyOffsets.clear();
+  adjacencyTargets.clear();
+}
+
+void GraphCore::reserveNodes(size_t numberOfNodes) {
+  xs.reserve(numberOfNodes);
+  ys.reserve(numberOfNodes);
+  names.reserve(numberOfNodes);
+}
+
+void GraphCore::reserveLinks(size_t numberOfLinks) {
+  links.reserve(numberOfLinks);
+}
+
+void GraphCore::assign(vector<double> newXs, vector<double> newYs, vector<string> newNames,
+                       vector<pair<NodeId, NodeId>> newLinks) {
+  if (newYs.size() != newXs.size() || newNames.size() != newXs.size()) {
+    throw runtime_error("Coordinates and names of nodes differ in number");
+  }
+  clear();
+  xs = move(newXs);
+  ys = move(newYs);
+  names = move(newNames);
+  links = move(newLinks);
+}
+
+GraphCore::NodeId GraphCore::addNode(double x, double y) {
+  return addNode(x, y, to_string(xs.size()));
+}
+
+GraphCore::NodeId GraphCore::addNode(double x, double y, string name) {
+  if (xs.size() >= size_t(NodeId(-1))) {
+    throw runtime_error("Too many nodes");
+  }
+  frozen = false;
+  xs.push_back(x);
+  ys.push_back(y);
+  names.push_back(move(name));
+  return NodeId(xs.size() - 1);
+}
+
+size_t GraphCore::addLink(NodeId first, NodeId second) {
+  if (frozen) {
+    frozen = false;
+    adjacencyOffsets.clear();
+    adjacencyTargets.clear();
+  }
+  links.emplace_back(first, second);
+  return links.size() - 1;
+}
+
+void GraphCore::freeze() {
+  if (frozen) {
+    return;
+  }
+
+  // Counting sort of link ends by node keeps the order of links within every list
+  adjacencyOffsets.assign(xs.size() + 1, 0);
+  for (const auto &[first, second]:links) {
+    ++adjacencyOffsets[first + 1];
+    ++adjacencyOffsets[second + 1];
+  }
+  for (size_t i = 1; i < adjacencyOffsets.size(); ++i) {
+    adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+  }
+
+  adjacencyTargets.resize(2 * links.size());
+  vector<size_t> positions(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+  for (const auto &[first, second]:links) {
+    adjacencyTargets[positions[first]++] = second;
+    adjacencyTargets[positions[second]++] = first;
+  }
+  frozen = true;
+}
+
+void GraphCore::removeRepeatedLinks() {
+  freeze();
+  // The packed adjacency holds every link, so the list of links is written over. A neighbour is marked by the node
+  // whose list it was last seen in, no node has the largest id.
+  vector<NodeId> markedBy(xs.size(), NodeId(-1));
+  links.clear();
+  for (NodeId node = 0; node < xs.size(); ++node) {
+    for (auto k = adjacencyOffsets[node]; k < adjacencyOffsets[node + 1]; ++k) {
+      auto neighbour = adjacencyTargets[k];
+      if (neighbour > node && markedBy[neighbour] != node) {
+        markedBy[neighbour] = node;
+        links.emplace_back(node, neighbour);
+      }
+    }
+  }
+  frozen = false;
+  freeze();
+}
+
+bool GraphCore::isFrozen() const {
+  return frozen;
+}
+
+size_t GraphCore::getNumberOfNodes() const {
+  return xs.size();
+}
+
+size_t GraphCore::getNumberOfLinks() const {
+  return links.size();
+}
+
+double GraphCore::getX(NodeId node) const {
+  return xs[node];
+}
+
+double GraphCore::getY(NodeId node) const {
+  return ys[node];
+}
+
+const string &GraphCore::getName(NodeId node) const {
+  return names[node];
+}
+
+void GraphCore::setX(NodeId node, double x) {
+  xs[node] = x;
+}
+
+void GraphCore::setY(NodeId node, double y) {
+  ys[node] = y;
+}
+
+void GraphCore::setName(NodeId node, string name) {
+  names[node] = move(name);
+}
+
+const vector<double> &GraphCore::getXs() const {
+  return xs;
+}
+
+const vector<double> &GraphCore::getYs() const {
+  return ys;
+}
+
+const pair<GraphCore::NodeId, GraphCore::NodeId> &GraphCore::getLink(size_t link) const {
+  return links[link];
+}
+
+const vector<pair<GraphCore::NodeId, GraphCore::NodeId>> &GraphCore::getLinks() const {
+  return links;
+}
+
+GraphCore::Neighbours GraphCore::getNeighbours(NodeId node) const {
+  if (!frozen) {
+    throw runtime_error("Graph core is not frozen");
+  }
+  const auto *targets = adjacencyTargets.data();
+  return {targets + adjacencyOffsets[node], targets + adjacencyOffsets[node + 1]};
+}
+
+size_t GraphCore::getDegree(NodeId node) const {
+  return getNeighbours(node).size();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+using std::vector;
+using std::string;
+using std::pair;
+
+// Nodes of a graph as plain indexes with coordinates and names in contiguous arrays. Links are kept in the order
+// they were added, adjacency lists are packed into one array (CSR) by freeze() once the links are all added.
+class GraphCore {
+public:
+  using NodeId = uint32_t;
+
+  // Neighbours of a node as a range over the packed adjacency
+  struct Neighbours {
+    const NodeId *first, *last;
+
+    [[nodiscard]] const NodeId *begin() const;
+
+    [[nodiscard]] const NodeId *end() const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] bool empty() const;
+  };
+
+private:
+  vector<double> xs, ys;
+  vector<string> names;
+  vector<pair<NodeId, NodeId>> links;
+
+  bool frozen = false;
+  vector<size_t> adjacencyOffsets;
+  vector<NodeId> adjacencyTargets;
+
+public:
+  void clear();
+
+  void reserveNodes(size_t numberOfNodes);
+
+  void reserveLinks(size_t numberOfLinks);
+
+  // Replaces the whole graph, coordinates and names have one element per node
+  void assign(vector<double> newXs, vector<double> newYs, vector<string> newNames,
+              vector<pair<NodeId, NodeId>> newLinks);
+
+  // Named by its id
+  NodeId addNode(double x, double y);
+
+  NodeId addNode(double x, double y, string name);
+
+  // Index of the added link, drops the packed adjacency until the next freeze()
+  size_t addLink(NodeId first, NodeId second);
+
+  // Packs adjacency lists, neighbours of every node are in the order their links were added
+  void freeze();
+
+  // Drops loops and all links but one between the same nodes, found in the packed adjacency, so it takes no memory
+  // per link. The links left are ordered by their smaller end, which comes first, and the core is frozen again.
+  void removeRepeatedLinks();
+
+  [[nodiscard]] bool isFrozen() const;
+
+  [[nodiscard]] size_t getNumberOfNodes() const;
+
+  [[nodiscard]] size_t getNumberOfLinks() const;
+
+  [[nodiscard]] double getX(NodeId node) const;
+
+  [[nodiscard]] double getY(NodeId node) const;
+
+  [[nodiscard]] const string &getName(NodeId node) const;
+
+  void setX(NodeId node, double x);
+
+  void setY(NodeId node, double y);
+
+  void setName(NodeId node, string name);
+
+  [[nodiscard]] const vector<double> &getXs() const;
+
+  [[nodiscard]] const vector<double> &getYs() const;
+
+  [[nodiscard]] const pair<NodeId, NodeId> &getLink(size_t link) const;
+
+  [[nodiscard]] const vector<pair<NodeId, NodeId>> &getLinks() const;
+
+  // The core has to be frozen
+  [[nodiscard]] Neighbours getNeighbours(NodeId node) const;
+
+  [[nodiscard]] size_t getDegree(NodeId node) const;
+};
@@ -0,0 +1,216 @@
+#include "GraphFile.h"
+#include "CompressedAdjacency.h"
+#include <cstring>
+#include <stdexcept>
+
+using std::runtime_error;
+using std::to_string;
+using std::move;
+
+constexpr char GraphFileHeader::expectedMagic[8];
+
+size_t alignToWord(size_t size) {
+  return (size + 7) / 8 * 8;
+}
+
+size_t getPackedTriangleWords(size_t numberOfNodes) {
+  size_t words = 0;
+  for (size_t i = 0; i < numberOfNodes; ++i) {
+    words += TriangleBoolSquareMatrix::getWordCount(i);
+  }
+  return words;
+}
+
+void writePadding(ostream &out, size_t size) {
+  static const char zeros[8] = {};
+  out.write(zeros, std::streamsize(alignToWord(size) - size));
+}
+
+void writeGraphFile(ostream &out, const GraphCore &core, const TriangleBoolSquareMatrix *matrix) {
+  size_t n = core.getNumberOfNodes(), numberOfLinks = core.getNumberOfLinks();
+  auto encoded = encodeAdjacency(n, core.getLinks());
+  size_t packedSize = matrix != nullptr ? getPackedTriangleWords(n) * sizeof(uint64_t) : 0;
+  size_t linkListSize = numberOfLinks * 2 * sizeof(uint32_t);
+
+  auto adjacencyKind = GraphFileHeader::LinkList;
+  size_t adjacencySize = linkListSize;
+  if (encoded.size() < adjacencySize) {
+    adjacencyKind = GraphFileHeader::DeltaVarint;
+    adjacencySize = encoded.size();
+  }
+  if (matrix != nullptr && packedSize < adjacencySize) {
+    adjacencyKind = GraphFileHeader::PackedTriangle;
+    adjacencySize = packedSize;
+  }
+
+  size_t namesCharacters = 0;
+  for (GraphCore::NodeId i = 0; i < n; ++i) {
+    namesCharacters += core.getName(i).size();
+  }
+
+  GraphFileHeader header{};
+  memcpy(header.magic, GraphFileHeader::expectedMagic, sizeof header.magic);
+  header.version = GraphFileHeader::currentVersion;
+  header.byteOrder = GraphFileHeader::byteOrderMark;
+  header.adjacencyKind = adjacencyKind;
+  header.numberOfNodes = n;
+  header.numberOfLinks = numberOfLinks;
+  header.coordinatesOffset = sizeof header;
+  header.adjacencyOffset = header.coordinatesOffset + 2 * n * sizeof(double);
+  header.adjacencySize = adjacencySize;
+  header.namesOffset = header.adjacencyOffset + alignToWord(header.adjacencySize);
+  header.namesSize = (n + 1) * sizeof(uint64_t) + namesCharacters;
+  out.write(reinterpret_cast<const char *>(&header), sizeof header);
+
+  out.write(reinterpret_cast<const char *>(core.getXs().data()), std::streamsize(n * sizeof(double)));
+  out.write(reinterpret_cast<const char *>(core.getYs().data()), std::streamsize(n * sizeof(double)));
+
+  if (adjacencyKind == GraphFileHeader::PackedTriangle) {
+    for (size_t i = 0; i < n; ++i) {
+      out.write(reinterpret_cast<const char *>(matrix->getRowWords(i)),
+                std::streamsize(TriangleBoolSquareMatrix::getWordCount(i) * sizeof(uint64_t)));
+    }
+  } else if (adjacencyKind == GraphFileHeader::DeltaVarint) {
+    out.write(reinterpret_cast<const char *>(encoded.data()), std::streamsize(encoded.size()));
+  } else {
+    vector<uint32_t> linkIds;
+    linkIds.reserve(2 * numberOfLinks);
+    for (const auto &[first, second]:core.getLinks()) {
+      linkIds.push_back(first);
+      linkIds.push_back(second);
+    }
+    out.write(reinterpret_cast<const char *>(linkIds.data()), std::streamsize(linkIds.size() * sizeof(uint32_t)));
+  }
+  writePadding(out, header.adjacencySize);
+
+  vector<uint64_t> nameOffsets(n + 1);
+  for (GraphCore::NodeId i = 0; i < n; ++i) {
+    nameOffsets[i + 1] = nameOffsets[i] + core.getName(i).size();
+  }
+  out.write(reinterpret_cast<const char *>(nameOffsets.data()), std::streamsize(nameOffsets.size() * sizeof(uint64_t)));
+  for (GraphCore::NodeId i = 0; i < n; ++i) {
+    out.write(core.getName(i).data(), std::streamsize(core.getName(i).size()));
+  }
+  writePadding(out, header.namesSize);
+
+  if (!out) {
+    throw runtime_error("IO error while writing graph file");
+  }
+}
+
+void checkBlock(uint64_t offset, uint64_t blockSize, size_t fileSize, const string &blockName) {
+  if (offset % 8 != 0 || offset > fileSize || blockSize > fileSize - offset) {
+    throw runtime_error("Corrupted graph file: " + blockName + " block is out of the file");
+  }
+}
+
+GraphCore readGraphFile(const char *data, size_t size) {
+  GraphFileHeader header{};
+  if (size < sizeof header) {
+    throw runtime_error("Corrupted graph file: it is shorter than its header");
+  }
+  memcpy(&header, data, sizeof header);
+  if (memcmp(header.magic, GraphFileHeader::expectedMagic, sizeof header.magic) != 0) {
+    throw runtime_error("Not a graph file");
+  }
+  if (header.version != GraphFileHeader::currentVersion) {
+    throw runtime_error("Unsupported graph file version " + to_string(header.version));
+  }
+  if (header.byteOrder != GraphFileHeader::byteOrderMark) {
+    throw runtime_error("Graph file was written with another byte order");
+  }
+
+  size_t n = header.numberOfNodes, numberOfLinks = header.numberOfLinks;
+  if (n > size / (2 * sizeof(double)) || n >= size_t(GraphCore::NodeId(-1))) {
+    throw runtime_error("Corrupted graph file: too many nodes");
+  }
+  checkBlock(header.coordinatesOffset, 2 * n * sizeof(double), size, "coordinates");
+  checkBlock(header.adjacencyOffset, header.adjacencySize, size, "adjacency");
+  checkBlock(header.namesOffset, header.namesSize, size, "names");
+  // Every kind of adjacency takes at least a bit a link
+  if (numberOfLinks / 8 > header.adjacencySize) {
+    throw runtime_error("Corrupted graph file: too many links for the adjacency block");
+  }
+
+  vector<double> xs(n), ys(n);
+  memcpy(xs.data(), data + header.coordinatesOffset, n * sizeof(double));
+  memcpy(ys.data(), data + header.coordinatesOffset + n * sizeof(double), n * sizeof(double));
+
+  vector<pair<GraphCore::NodeId, GraphCore::NodeId>> links;
+  const char *adjacency = data + header.adjacencyOffset;
+  if (header.adjacencyKind == GraphFileHeader::LinkList) {
+    if (header.adjacencySize % (2 * sizeof(uint32_t)) != 0 ||
+        header.adjacencySize / (2 * sizeof(uint32_t)) != numberOfLinks) {
+      throw runtime_error("Corrupted graph file: size of links does not match their number");
+    }
+    vector<uint32_t> linkIds(2 * numberOfLinks);
+    memcpy(linkIds.data(), adjacency, linkIds.size() * sizeof(uint32_t));
+    links.reserve(numberOfLinks);
+    for (size_t i = 0; i < numberOfLinks; ++i) {
+      if (linkIds[2 * i] >= n || linkIds[2 * i + 1] >= n) {
+        throw runtime_error("Corrupted graph file: link " + to_string(i) + " goes out of the graph");
+      }
+      links.emplace_back(linkIds[2 * i], linkIds[2 * i + 1]);
+    }
+  } else if (header.adjacencyKind == GraphFileHeader::PackedTriangle) {
+    if (header.adjacencySize != getPackedTriangleWords(n) * sizeof(uint64_t)) {
+      throw runtime_error("Corrupted graph file: size of packed adjacency does not match the number of nodes");
+    }
+    links.reserve(numberOfLinks);
+    const char *row = adjacency;
+    // Links are checked against the header as they are found, a corrupted row cannot make more of them
+    for (size_t i = 0; i < n; ++i) {
+      auto wordCount = TriangleBoolSquareMatrix::getWordCount(i);
+      for (size_t k = 0; k < wordCount; ++k) {
+        uint64_t word;
+        memcpy(&word, row + k * sizeof(uint64_t), sizeof word);
+        while (word != 0) {
+          auto j = k * 64 + TriangleBoolSquareMatrix::getLowestBit(word);
+          if (j >= i) {
+            throw runtime_error("Corrupted graph file: packed adjacency has bits past the end of row " + to_string(i));
+          }
+          if (links.size() == numberOfLinks) {
+            throw runtime_error("Corrupted graph file: packed adjacency has more links than the header");
+          }
+          links.emplace_back(i, j);
+          word &= word - 1;
+        }
+      }
+      row += wordCount * sizeof(uint64_t);
+    }
+    if (links.size() != numberOfLinks) {
+      throw runtime_error("Corrupted graph file: packed adjacency has fewer links than the header");
+    }
+  } else if (header.adjacencyKind == GraphFileHeader::DeltaVarint) {
+    // Links are counted as they are decoded, a corrupted number of them cannot reserve too much
+    links.reserve(std::min(numberOfLinks, size_t(header.adjacencySize)));
+    auto *bytes = reinterpret_cast<const uint8_t *>(adjacency);
+    decodeAdjacency(bytes, header.adjacencySize, n, [&links](size_t i, size_t j) {
+      links.emplace_back(i, j);
+    });
+    if (links.size() != numberOfLinks) {
+      throw runtime_error("Corrupted graph file: number of compressed links does not match the header");
+    }
+  } else {
+    throw runtime_error("Unknown adjacency kind " + to_string(header.adjacencyKind) + " in graph file");
+  }
+
+  if (header.namesSize < (n + 1) * sizeof(uint64_t)) {
+    throw runtime_error("Corrupted graph file: names block is too short");
+  }
+  vector<uint64_t> nameOffsets(n + 1);
+  memcpy(nameOffsets.data(), data + header.namesOffset, nameOffsets.size() * sizeof(uint64_t));
+  const char *characters = data + header.namesOffset + nameOffsets.size() * sizeof(uint64_t);
+  size_t charactersSize = header.namesSize - nameOffsets.size() * sizeof(uint64_t);
+  vector<string> names(n);
+  for (size_t i = 0; i < n; ++i) {
+    if (nameOffsets[i] > nameOffsets[i + 1] || nameOffsets[i + 1] > charactersSize) {
+      throw runtime_error("Corrupted graph file: name of node " + to_string(i) + " is out of the names block");
+    }
+    names[i].assign(characters + nameOffsets[i], characters + nameOffsets[i + 1]);
+  }
+
+  GraphCore core;
+  core.assign(move(xs), move(ys), move(names), move(links));
+  return core;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "GraphCore.h"
+#include "TriangleBoolSquareMatrix.h"
+#include <cstdint>
+#include <iostream>
+
+using std::ostream;
+
+enum class GraphFileFormat {
+  // Adjacency matrix in matrix/ and coordinates with names in nodes/, both as text
+  Text,
+  // Single file in graphs/, read through a memory mapping
+  Binary,
+  // Links as lines of node ids in edges/, nodes in a header
+  EdgeList
+};
+
+// Start of a binary graph file. Blocks follow it at offsets aligned to 8 bytes, numbers are in the byte order of
+// the machine that wrote the file:
+// - coordinates: n doubles of x, then n doubles of y;
+// - adjacency: links as pairs of uint32_t node ids, rows of the packed lower triangle of the adjacency matrix,
+//   row i taking ceil(i / 64) uint64_t words, or rows of neighbours coded by encodeAdjacency;
+// - names: n + 1 uint64_t offsets of names in the characters following them.
+struct GraphFileHeader {
+  static constexpr char expectedMagic[8] = {'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N'};
+  static constexpr uint32_t currentVersion = 1;
+  static constexpr uint32_t byteOrderMark = 0x01020304;
+
+  enum AdjacencyKind : uint32_t {
+    LinkList = 0,
+    PackedTriangle = 1,
+    DeltaVarint = 2
+  };
+
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t adjacencyKind;
+  uint32_t reserved;
+  uint64_t numberOfNodes;
+  uint64_t numberOfLinks;
+  uint64_t coordinatesOffset;
+  uint64_t adjacencyOffset, adjacencySize;
+  uint64_t namesOffset, namesSize;
+};
+
+// Adjacency is written in the smallest of the kinds, the packed matrix only when it is given
+void writeGraphFile(ostream &out, const GraphCore &core, const TriangleBoolSquareMatrix *matrix);
+
+// Core of the graph in a whole file, links in the order of the file
+GraphCore readGraphFile(const char *data, size_t size);
@@ -0,0 +1,80 @@
+#include "GraphJob.h"
+
+using std::make_unique;
+using std::make_shared;
+using std::move;
+using std::current_exception;
+using std::rethrow_exception;
+
+GraphJob::~GraphJob() {
+  stop();
+  for (auto &[stoppedWorker, stoppedRun]:stoppedWorkers) {
+    stoppedWorker.join();
+  }
+}
+
+void GraphJob::stop() {
+  if (worker.joinable()) {
+    run->progress.cancel();
+    stoppedWorkers.emplace_back(move(worker), move(run));
+  }
+}
+
+void GraphJob::joinDoneStoppedWorkers() {
+  for (auto stopped = stoppedWorkers.begin(); stopped != stoppedWorkers.end();) {
+    if (stopped->second->done) {
+      stopped->first.join();
+      stopped = stoppedWorkers.erase(stopped);
+    } else {
+      ++stopped;
+    }
+  }
+}
+
+void GraphJob::start(function<Graph(JobProgress &)> build) {
+  stop();
+  joinDoneStoppedWorkers();
+  run = make_shared<Run>();
+
+  worker = thread([run = run, build = move(build)]() {
+    try {
+      run->result = make_unique<Graph>(build(run->progress));
+    } catch (const JobCancelled &) {
+    } catch (...) {
+      run->failure = current_exception();
+    }
+    run->done = true;
+  });
+}
+
+void GraphJob::cancel() {
+  if (run) {
+    run->progress.cancel();
+  }
+}
+
+bool GraphJob::isRunning() const {
+  return worker.joinable();
+}
+
+double GraphJob::getProgress() const {
+  return run ? run->progress.getFraction() : 0;
+}
+
+bool GraphJob::collect(Graph &target) {
+  joinDoneStoppedWorkers();
+  if (!worker.joinable() || !run->done) {
+    return false;
+  }
+  worker.join();
+  auto finished = move(run);
+
+  if (finished->failure) {
+    rethrow_exception(finished->failure);
+  }
+  if (!finished->result) {
+    return false;
+  }
+  target = move(*finished->result);
+  return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Graph.h"
+#include "JobProgress.h"
+#include <functional>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <utility>
+#include <vector>
+
+using std::function;
+using std::thread;
+using std::unique_ptr;
+using std::shared_ptr;
+using std::exception_ptr;
+using std::pair;
+using std::vector;
+
+// Builds a graph on a worker thread. The graph shown meanwhile is not touched, the built one replaces it only
+// when it is collected on the thread that draws it.
+class GraphJob {
+  // What a worker shares with the job, a cancelled worker keeps its own while it winds down
+  struct Run {
+    JobProgress progress;
+    atomic<bool> done{false};
+    unique_ptr<Graph> result;
+    exception_ptr failure;
+  };
+
+  thread worker;
+  shared_ptr<Run> run;
+  // Cancelled workers not known to be done yet. Not every builder checks for cancellation, so they are joined
+  // once done rather than when the next job starts, which would stall the thread that draws.
+  vector<pair<thread, shared_ptr<Run>>> stoppedWorkers;
+
+  // Cancels the worker and leaves it to finish among the stopped ones
+  void stop();
+
+  void joinDoneStoppedWorkers();
+
+public:
+  GraphJob() = default;
+
+  GraphJob(const GraphJob &) = delete;
+
+  GraphJob &operator=(const GraphJob &) = delete;
+
+  ~GraphJob();
+
+  // Cancels the job running, if any, and starts building a new graph
+  void start(function<Graph(JobProgress &)> build);
+
+  void cancel();
+
+  // True from the start of a job till it is collected
+  [[nodiscard]] bool isRunning() const;
+
+  [[nodiscard]] double getProgress() const;
+
+  // Moves the graph of a finished job into target and returns true. Returns false while the job runs or when
+  // it was cancelled, rethrows the error of a failed job. Joins cancelled workers that are done.
+  bool collect(Graph &target);
+};
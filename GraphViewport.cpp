@@ -0,0 +1,35 @@
+#include "GraphViewport.h"
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+void GraphViewport::fit(const sf::FloatRect &bounds, sf::Vector2f canvasSize) {
+  centerX = bounds.left + bounds.width / 2.;
+  centerY = bounds.top + bounds.height / 2.;
+  if (canvasSize.x <= 0 || canvasSize.y <= 0) {
+    return;
+  }
+  double fitting = max(bounds.width / canvasSize.x, bounds.height / canvasSize.y) * 1.2;
+  unitsPerPixel = min(max(fitting, minUnitsPerPixel), maxUnitsPerPixel);
+}
+
+void GraphViewport::zoom(double factor, sf::Vector2f pixel, sf::Vector2f canvasSize) {
+  double offsetX = pixel.x - canvasSize.x / 2., offsetY = pixel.y - canvasSize.y / 2.;
+  double pointX = centerX + offsetX * unitsPerPixel, pointY = centerY + offsetY * unitsPerPixel;
+  unitsPerPixel = min(max(unitsPerPixel * factor, minUnitsPerPixel), maxUnitsPerPixel);
+  centerX = pointX - offsetX * unitsPerPixel;
+  centerY = pointY - offsetY * unitsPerPixel;
+}
+
+void GraphViewport::pan(sf::Vector2f pixelDelta) {
+  centerX -= pixelDelta.x * unitsPerPixel;
+  centerY -= pixelDelta.y * unitsPerPixel;
+}
+
+sf::View GraphViewport::getView(sf::Vector2f canvasSize) const {
+  sf::View view;
+  view.setCenter(float(centerX), float(centerY));
+  view.setSize(float(canvasSize.x * unitsPerPixel), float(canvasSize.y * unitsPerPixel));
+  return view;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// Part of the plane shown on a canvas, kept as the point at the centre of the canvas and units per pixel, so that
+// resizing the canvas shows more of the plane instead of stretching it
+class GraphViewport {
+  double centerX = 300, centerY = 300, unitsPerPixel = 1;
+
+public:
+  static constexpr double minUnitsPerPixel = 1e-3, maxUnitsPerPixel = 1e4;
+
+  // Shows the whole rectangle with a margin of its tenth
+  void fit(const sf::FloatRect &bounds, sf::Vector2f canvasSize);
+
+  // Scales the units per pixel by factor, the point under the pixel of the canvas stays in place
+  void zoom(double factor, sf::Vector2f pixel, sf::Vector2f canvasSize);
+
+  // Moves the plane along with the mouse dragged by the pixels
+  void pan(sf::Vector2f pixelDelta);
+
+  [[nodiscard]] sf::View getView(sf::Vector2f canvasSize) const;
+};
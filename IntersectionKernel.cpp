@@ -0,0 +1,133 @@
+#include "IntersectionKernel.h"
+#include <cmath>
+
+void IntersectionKernel::reset(double nodeRadius) {
+  exact = false;
+  radius = nodeRadius;
+  columns.clear();
+  rows.clear();
+}
+
+void IntersectionKernel::reset(const GraphCore &core, double nodeRadius, double originX, double originY,
+                               double step) {
+  reset(nodeRadius);
+
+  // Only coordinates computed exactly as origin + index * step are on the lattice
+  auto numberOfNodes = core.getNumberOfNodes();
+  columns.resize(numberOfNodes);
+  rows.resize(numberOfNodes);
+  for (GraphCore::NodeId i = 0; i < numberOfNodes; ++i) {
+    double column = std::round((core.getX(i) - originX) / step), row = std::round((core.getY(i) - originY) / step);
+    if (column < 0 || row < 0 || column > maxLatticeCoord || row > maxLatticeCoord ||
+        originX + double(size_t(column)) * step != core.getX(i) ||
+        originY + double(size_t(row)) * step != core.getY(i)) {
+      reset(nodeRadius);
+      return;
+    }
+    columns[i] = column;
+    rows[i] = row;
+  }
+
+  exact = true;
+  latticeRadiusSquared = (nodeRadius * nodeRadius + 1e-10) / (step * step);
+}
+
+bool IntersectionKernel::isExact() const {
+  return exact;
+}
+
+const vector<double> &IntersectionKernel::getColumns() const {
+  return columns;
+}
+
+const vector<double> &IntersectionKernel::getRows() const {
+  return rows;
+}
+
+IntersectionKernel::Query IntersectionKernel::makeQuery(const GraphCore &core, size_t firstNode,
+                                                        size_t secondNode) const {
+  double x1 = core.getX(firstNode), y1 = core.getY(firstNode), x2 = core.getX(secondNode), y2 = core.getY(secondNode);
+  Link link(x1, y1, x2, y2);
+  if (exact) {
+    x1 = columns[firstNode];
+    y1 = rows[firstNode];
+    x2 = columns[secondNode];
+    y2 = rows[secondNode];
+  }
+  double dx = x2 - x1, dy = y2 - y1;
+  return {firstNode, secondNode, x1, y1, x2, y2, dx, dy, dx * dx + dy * dy, link};
+}
+
+bool IntersectionKernel::anyNodeTouches(const GraphCore &core, const Query &query, const vector<size_t> &nodes,
+                                        size_t &numberOfTests) const {
+  if (!exact) {
+    for (auto node:nodes) {
+      ++numberOfTests;
+      if (node != query.firstNode && node != query.secondNode &&
+          query.link.doIntersect(core.getX(node), core.getY(node), radius)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (query.lengthSquared == 0) {
+    return false;
+  }
+  // The disc is touched when the projection of its centre falls on the segment and the centre is within the
+  // radius of the line: cross² / length² < r². Ends are told apart by coordinates, no two nodes share them.
+  double x1 = query.x1, y1 = query.y1, x2 = query.x2, y2 = query.y2, dx = query.dx, dy = query.dy;
+  double lengthSquared = query.lengthSquared, bound = latticeRadiusSquared * lengthSquared;
+  for (auto node:nodes) {
+    ++numberOfTests;
+    double x = columns[node], y = rows[node];
+    if ((x == x1 && y == y1) || (x == x2 && y == y2)) {
+      continue;
+    }
+    double px = x - x1, py = y - y1;
+    double projection = px * dx + py * dy, cross = dx * py - dy * px;
+    if (projection >= 0 && projection <= lengthSquared && cross * cross < bound) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IntersectionKernel::anyLinkCrosses(const GraphCore &core, const Query &query, const vector<size_t> &links,
+                                        size_t &numberOfTests) const {
+  if (!exact) {
+    for (auto link:links) {
+      ++numberOfTests;
+      auto[first, second] = core.getLink(link);
+      if (query.link.doIntersect(Link(core.getX(first), core.getY(first), core.getX(second), core.getY(second)))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Segments not parallel and not sharing an end meet when the ends of each are not strictly on one side of
+  // the other. All orientations are exact, only the signs of their products are used.
+  double x1 = query.x1, y1 = query.y1, x2 = query.x2, y2 = query.y2, dx = query.dx, dy = query.dy;
+  for (auto link:links) {
+    ++numberOfTests;
+    auto[first, second] = core.getLink(link);
+    double rx = columns[first], ry = rows[first], sx = columns[second], sy = rows[second];
+    if ((rx == x1 && ry == y1) || (rx == x2 && ry == y2) || (sx == x1 && sy == y1) || (sx == x2 && sy == y2)) {
+      continue;
+    }
+    double ex = sx - rx, ey = sy - ry;
+    if (dx * ey - dy * ex == 0) {
+      continue;
+    }
+    double d1 = dx * (ry - y1) - dy * (rx - x1), d2 = dx * (sy - y1) - dy * (sx - x1);
+    if (d1 * d2 > 0) {
+      continue;
+    }
+    double d3 = ex * (y1 - ry) - ey * (x1 - rx), d4 = ex * (y2 - ry) - ey * (x2 - rx);
+    if (d3 * d4 <= 0) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GraphCore.h"
+#include "Link.h"
+#include <vector>
+#include <cstddef>
+
+using std::vector;
+
+// Tests one segment against the links and node discs of a cell, stopping at the first hit. Nodes placed on a
+// lattice are kept in lattice steps, where orientation predicates are exact integer arithmetic carried out in
+// doubles; other nodes go through the floating-point tests of Link. The exact tests are there for correct
+// decisions, the absolute tolerance of Link misses crossings at large coordinates, not for speed: they cost about
+// as much as those of Link, and decide differently where Link is wrong.
+class IntersectionKernel {
+  // Products of differences of coordinates below it stay below 2^53, so they are exact in doubles
+  static constexpr double maxLatticeCoord = double(1u << 24u);
+
+  bool exact = false;
+  double radius = 0;
+  // Squared radius in squared lattice steps, with the tolerance of Link
+  double latticeRadiusSquared = 0;
+  vector<double> columns, rows;
+
+public:
+  // Segment between two nodes, prepared for testing against cells
+  struct Query {
+    size_t firstNode, secondNode;
+    // In lattice steps when the kernel is exact
+    double x1, y1, x2, y2;
+    double dx, dy, lengthSquared;
+    Link link;
+  };
+
+  // Nodes anywhere in the plane, tested in floating point
+  void reset(double nodeRadius);
+
+  // Nodes at origin + (column, row) * step are tested exactly, otherwise falls back to floating point
+  void reset(const GraphCore &core, double nodeRadius, double originX, double originY, double step);
+
+  [[nodiscard]] bool isExact() const;
+
+  // Lattice column and row of every node, empty unless the kernel is exact
+  [[nodiscard]] const vector<double> &getColumns() const;
+
+  [[nodiscard]] const vector<double> &getRows() const;
+
+  [[nodiscard]] Query makeQuery(const GraphCore &core, size_t firstNode, size_t secondNode) const;
+
+  // Whether the segment touches the disc of any of the nodes other than its ends, adds the number of nodes tested
+  // before the answer was known to numberOfTests
+  [[nodiscard]] bool anyNodeTouches(const GraphCore &core, const Query &query, const vector<size_t> &nodes,
+                                    size_t &numberOfTests) const;
+
+  // Whether the segment crosses or touches any of the links not sharing an end with it, adds the number of links
+  // tested before the answer was known to numberOfTests
+  [[nodiscard]] bool anyLinkCrosses(const GraphCore &core, const Query &query, const vector<size_t> &links,
+                                    size_t &numberOfTests) const;
+};
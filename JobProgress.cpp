@@ -0,0 +1,33 @@
+#include "JobProgress.h"
+
+using std::memory_order_relaxed;
+
+JobCancelled::JobCancelled() : runtime_error("Job is cancelled") {}
+
+void JobProgress::reset() {
+  fraction = 0;
+  cancelled = false;
+}
+
+void JobProgress::report(double doneFraction) {
+  fraction.store(doneFraction, memory_order_relaxed);
+  check();
+}
+
+void JobProgress::check() const {
+  if (cancelled.load(memory_order_relaxed)) {
+    throw JobCancelled();
+  }
+}
+
+void JobProgress::cancel() {
+  cancelled = true;
+}
+
+double JobProgress::getFraction() const {
+  return fraction.load(memory_order_relaxed);
+}
+
+bool JobProgress::isCancelled() const {
+  return cancelled;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <stdexcept>
+
+using std::atomic;
+using std::runtime_error;
+
+// Thrown out of a job once its cancellation is requested
+class JobCancelled : public runtime_error {
+public:
+  JobCancelled();
+};
+
+// Progress of a long job, reported by the thread running it and watched by another one that may cancel it
+class JobProgress {
+  atomic<double> fraction{0};
+  atomic<bool> cancelled{false};
+
+public:
+  void reset();
+
+  // Fraction of the job done, throws JobCancelled once cancellation is requested
+  void report(double doneFraction);
+
+  // Throws JobCancelled once cancellation is requested
+  void check() const;
+
+  void cancel();
+
+  [[nodiscard]] double getFraction() const;
+
+  [[nodiscard]] bool isCancelled() const;
+};
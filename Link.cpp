@@ -5,12 +5,9 @@
 #include "Link.h"
 #include <cmath>
 
-Link::Link(shared_ptr<Node> first, shared_ptr<Node> second) : first(move(first)), second(move(second)) {
-  x1 = this->first->x;
-  y1 = this->first->y;
-  x2 = this->second->x;
-  y2 = this->second->y;
+const sf::Color Link::color(225, 156, 36);
 
+Link::Link(double x1, double y1, double x2, double y2) : x1(x1), x2(x2), y1(y1), y2(y2) {
   a = y2 - y1;
   b = x1 - x2;
   c = x2 * y1 - x1 * y2;
@@ -30,13 +27,18 @@ bool isIn(double x, double x1, double x2) {
   }
 }
 
-void Link::draw(sf::RenderTarget &target, sf::RenderStates states) const {
-  double nx = a / l, ny = b / l;
-  for (int i = -4; i < 5; ++i) {
-    sf::Vertex lineVertexes[] = {sf::Vector2f(x1 + i * nx / 2., y1 + i * ny / 2.),
-                                 sf::Vector2f(x2 + i * nx / 2., y2 + i * ny / 2.)};
-    lineVertexes[0].color = lineVertexes[1].color = sf::Color(225, 156, 36);
-    target.draw(lineVertexes, 2, sf::Lines, states);
+void Link::appendTriangles(sf::VertexArray &vertices) const {
+  if (l == 0) {
+    return;
+  }
+  // (a, b) is normal to the link
+  double nx = a / l * width / 2, ny = b / l * width / 2;
+  sf::Vertex corners[] = {sf::Vertex(sf::Vector2f(x1 - nx, y1 - ny), color),
+                          sf::Vertex(sf::Vector2f(x1 + nx, y1 + ny), color),
+                          sf::Vertex(sf::Vector2f(x2 + nx, y2 + ny), color),
+                          sf::Vertex(sf::Vector2f(x2 - nx, y2 - ny), color)};
+  for (auto corner:{0, 1, 2, 0, 2, 3}) {
+    vertices.append(corners[corner]);
   }
 }
 
@@ -53,18 +55,15 @@ bool Link::doIntersect(const Link &otherLine) const {
   return false;
 }
 
-bool Link::doIntersect(const Node &node) const {
-  double x0 = node.x, y0 = node.y;
+bool Link::doIntersect(double x0, double y0, double radius) const {
   if (!eq(l, 0) && !(eq(x1, x0) && eq(y1, y0) || eq(x2, x0) && eq(y2, y0))) {
     double x = (b * b * x0 - a * (c + b * y0)) / l / l, y = (a * a * y0 - b * (c + a * x0)) / l / l;
     if (isIn(x, x1, x2) && isIn(y, y1, y2)) {
-      double dx = x - x0, dy = y - y0, r = Node::NodeSettings::getNodeSettings().radius;
-      if (dx * dx + dy * dy < r * r + 1e-10) {
+      double dx = x - x0, dy = y - y0;
+      if (dx * dx + dy * dy < radius * radius + 1e-10) {
         return true;
       }
     }
   }
   return false;
 }
-
-Link::~Link() = default;
@@ -5,18 +5,23 @@
 
 #include "Node.h"
 
-struct Link : public sf::Drawable {
+// Segment of a link between two nodes, made on the fly from the coordinates in the graph core
+struct Link {
   double a, b, c, l;
   double x1, x2, y1, y2;
-  shared_ptr<Node> first, second;
 
-  Link(shared_ptr<Node> first, shared_ptr<Node> second);
+  // Thickness of a drawn link in pixels
+  static constexpr double width = 5;
 
-  ~Link() override;
+  static const sf::Color color;
 
-  void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+  Link(double x1, double y1, double x2, double y2);
+
+  // Appends the link as a rectangle of two triangles, nothing for a link of zero length
+  void appendTriangles(sf::VertexArray &vertices) const;
 
   [[nodiscard]] bool doIntersect(const Link &otherLine) const;
 
-  [[nodiscard]] bool doIntersect(const Node &node) const;
+  // Whether the disc of the radius around a node at (x0, y0) touches the link
+  [[nodiscard]] bool doIntersect(double x0, double y0, double radius) const;
 };
\ No newline at end of file
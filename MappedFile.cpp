@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define GRAPH_RENDERER_HAS_MMAP
+#endif
+
+using std::runtime_error;
+using std::ifstream;
+
+MappedFile::MappedFile(const string &path) {
+#ifdef GRAPH_RENDERER_HAS_MMAP
+  int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw runtime_error("Unable to open " + path);
+  }
+  struct stat status{};
+  if (fstat(descriptor, &status) != 0) {
+    close(descriptor);
+    throw runtime_error("Unable to read size of " + path);
+  }
+  mappedSize = size_t(status.st_size);
+  if (mappedSize > 0) {
+    void *address = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (address == MAP_FAILED) {
+      close(descriptor);
+      throw runtime_error("Unable to map " + path);
+    }
+    mappedData = static_cast<const char *>(address);
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(descriptor);
+#else
+  ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw runtime_error("Unable to open " + path);
+  }
+  buffer.resize(size_t(in.tellg()));
+  in.seekg(0);
+  in.read(buffer.data(), std::streamsize(buffer.size()));
+  if (!in) {
+    throw runtime_error("IO error while reading " + path);
+  }
+  mappedData = buffer.data();
+  mappedSize = buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef GRAPH_RENDERER_HAS_MMAP
+  if (mappedData != nullptr) {
+    munmap(const_cast<char *>(mappedData), mappedSize);
+  }
+#endif
+}
+
+const char *MappedFile::data() const {
+  return mappedData;
+}
+
+size_t MappedFile::size() const {
+  return mappedSize;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using std::string;
+using std::vector;
+
+// Read-only view of a whole file, mapped into memory where the system allows it and read into a buffer otherwise
+class MappedFile {
+  const char *mappedData = nullptr;
+  size_t mappedSize = 0;
+  vector<char> buffer;
+
+public:
+  explicit MappedFile(const string &path);
+
+  MappedFile(const MappedFile &) = delete;
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile();
+
+  [[nodiscard]] const char *data() const;
+
+  [[nodiscard]] size_t size() const;
+};
@@ -3,29 +3,37 @@
 //
 
 #include "Node.h"
-#include "TextFactory.h"
+#include <cmath>
 
-using std::to_string;
-
-Node::Node(size_t id, double x, double y) : id(id), name(to_string(id)), x(x), y(y) {}
-
-Node::~Node() = default;
+// The texture has a pixel of margin around the disc for its smoothed edge
+size_t getDiscTextureSide(double radius) {
+  return size_t(std::ceil(2 * radius)) + 2;
+}
 
-void Node::draw(sf::RenderTarget &target, sf::RenderStates states) const {
+void Node::drawDiscTexture(sf::RenderTexture &texture) {
   auto &nodeSettings = NodeSettings::getNodeSettings();
+  auto side = unsigned(getDiscTextureSide(nodeSettings.radius));
+  texture.create(side, side);
+  texture.setSmooth(true);
+  texture.clear(sf::Color::Transparent);
   sf::CircleShape circleShape((float(nodeSettings.radius)));
   circleShape.setFillColor(nodeSettings.color);
-  circleShape.setPosition(float(x - nodeSettings.radius), float(y - nodeSettings.radius));
+  circleShape.setPosition(1, 1);
+  texture.draw(circleShape);
+  texture.display();
+}
 
-  auto text = TextFactory::getTextFactory().getText(name);
-  {
-    const auto &textLocalBounds = text.getLocalBounds();
-    text.setPosition(sf::Vector2f(x - textLocalBounds.width / 2. - textLocalBounds.left,
-                                  y - textLocalBounds.height / 2. - textLocalBounds.top));
+void Node::appendDisc(sf::VertexArray &vertices, double x, double y) {
+  auto radius = NodeSettings::getNodeSettings().radius;
+  auto side = float(getDiscTextureSide(radius));
+  float left = float(x - radius) - 1, top = float(y - radius) - 1;
+  sf::Vertex corners[] = {sf::Vertex(sf::Vector2f(left, top), sf::Color::White, sf::Vector2f(0, 0)),
+                          sf::Vertex(sf::Vector2f(left + side, top), sf::Color::White, sf::Vector2f(side, 0)),
+                          sf::Vertex(sf::Vector2f(left + side, top + side), sf::Color::White, sf::Vector2f(side, side)),
+                          sf::Vertex(sf::Vector2f(left, top + side), sf::Color::White, sf::Vector2f(0, side))};
+  for (auto corner:{0, 1, 2, 0, 2, 3}) {
+    vertices.append(corners[corner]);
   }
-
-  target.draw(circleShape, states);
-  target.draw(text, states);
 }
 
 Node::NodeSettings &Node::NodeSettings::getNodeSettings() {
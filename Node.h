@@ -3,17 +3,19 @@
 //
 #pragma once
 
-#include <memory>
 #include <SFML/Graphics.hpp>
 
 using std::string;
 using std::vector;
-using std::shared_ptr;
 
-struct Node : public sf::Drawable {
+// Settings and drawing of the nodes of a graph, whose positions and names are in the graph core
+struct Node {
   struct NodeSettings {
     double radius = 10;
     sf::Color color;
+    // Levels of detail: nodes narrower than this many pixels are drawn as points, labels smaller are not drawn
+    double minimumDiscPixels = 3;
+    double minimumLabelPixels = 4;
 
     static NodeSettings &getNodeSettings();
 
@@ -21,14 +23,9 @@ struct Node : public sf::Drawable {
     NodeSettings();
   };
 
-  size_t id;
-  string name;
-  double x = 0, y = 0;
-  vector<shared_ptr<Node>> adjacentNodes;
+  // Makes the texture of the size of a disc of the radius and colour of the settings and draws the disc into it
+  static void drawDiscTexture(sf::RenderTexture &texture);
 
-  Node(size_t id, double x, double y);
-
-  ~Node() override;
-
-  void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+  // Appends a quad of the disc texture centred at (x, y), two triangles
+  static void appendDisc(sf::VertexArray &vertices, double x, double y);
 };
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "NodePlacement.h"
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using std::unordered_set;
+using std::uniform_int_distribution;
+using std::uniform_real_distribution;
+using std::shuffle;
+using std::uint64_t;
+
+// Floyd's algorithm: the j-th step takes a random number of [0, j] or j itself if that one is taken already.
+// Taken numbers are kept in a bitset while it is smaller than a hash set of the sample would be.
+vector<size_t> sampleDistinct(size_t populationSize, size_t count, mt19937 &engine) {
+  vector<size_t> result;
+  result.reserve(count);
+
+  if (populationSize / 64 <= count * 8) {
+    vector<uint64_t> taken((populationSize + 63) / 64);
+    for (size_t j = populationSize - count; j < populationSize; ++j) {
+      auto number = uniform_int_distribution<size_t>(0, j)(engine);
+      if (taken[number / 64] >> (number % 64) & 1u) {
+        number = j;
+      }
+      taken[number / 64] |= uint64_t(1) << (number % 64);
+      result.push_back(number);
+    }
+  } else {
+    unordered_set<size_t> taken(count * 2);
+    for (size_t j = populationSize - count; j < populationSize; ++j) {
+      auto number = uniform_int_distribution<size_t>(0, j)(engine);
+      if (!taken.insert(number).second) {
+        number = j;
+        taken.insert(number);
+      }
+      result.push_back(number);
+    }
+  }
+
+  // Floyd's algorithm gives a uniform set, but late numbers are biased towards the end of the population
+  shuffle(result.begin(), result.end(), engine);
+  return result;
+}
+
+vector<pair<double, double>> samplePoissonDisk(double minCoord, double maxCoord, double minDistance,
+                                               mt19937 &engine) {
+  const int attemptsPerPoint = 30;
+  const size_t none = size_t(-1);
+
+  vector<pair<double, double>> points;
+  if (maxCoord < minCoord) {
+    return points;
+  }
+
+  // A cell is small enough to hold one point at most
+  double cellSize = minDistance / std::sqrt(2.);
+  auto side = size_t((maxCoord - minCoord) / cellSize) + 1;
+  vector<size_t> cells(side * side, none);
+  auto getCell = [&](double coord) {
+    return std::min(size_t((coord - minCoord) / cellSize), side - 1);
+  };
+
+  auto isFree = [&](double x, double y) {
+    auto column = getCell(x), row = getCell(y);
+    for (size_t i = row < 2 ? 0 : row - 2; i <= std::min(row + 2, side - 1); ++i) {
+      for (size_t j = column < 2 ? 0 : column - 2; j <= std::min(column + 2, side - 1); ++j) {
+        auto point = cells[i * side + j];
+        if (point != none) {
+          double dx = points[point].first - x, dy = points[point].second - y;
+          if (dx * dx + dy * dy < minDistance * minDistance) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  };
+
+  auto addPoint = [&](double x, double y) {
+    cells[getCell(y) * side + getCell(x)] = points.size();
+    points.emplace_back(x, y);
+  };
+
+  uniform_real_distribution<double> coordDistribution(minCoord, maxCoord);
+  addPoint(coordDistribution(engine), coordDistribution(engine));
+
+  // Active points still may have free space around them
+  vector<size_t> active{0};
+  uniform_real_distribution<double> angleDistribution(0, 2 * M_PI);
+  uniform_real_distribution<double> squaredRadiusDistribution(minDistance * minDistance,
+                                                              4 * minDistance * minDistance);
+  while (!active.empty()) {
+    auto activeIndex = uniform_int_distribution<size_t>(0, active.size() - 1)(engine);
+    auto[x, y] = points[active[activeIndex]];
+
+    bool added = false;
+    for (int attempt = 0; attempt < attemptsPerPoint && !added; ++attempt) {
+      // Uniform in the annulus between minDistance and twice of it
+      double angle = angleDistribution(engine), radius = std::sqrt(squaredRadiusDistribution(engine));
+      double newX = x + radius * std::cos(angle), newY = y + radius * std::sin(angle);
+      if (newX >= minCoord && newX <= maxCoord && newY >= minCoord && newY <= maxCoord && isFree(newX, newY)) {
+        active.push_back(points.size());
+        addPoint(newX, newY);
+        added = true;
+      }
+    }
+
+    if (!added) {
+      active[activeIndex] = active.back();
+      active.pop_back();
+    }
+  }
+
+  return points;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <utility>
+
+using std::vector;
+using std::pair;
+using std::mt19937;
+
+enum class NodePlacement {
+  // Distinct random cells of a square lattice
+  Lattice,
+  // Evenly spread points at least a lattice step apart
+  PoissonDisk
+};
+
+// count distinct numbers from [0, populationSize) in random order, each number is drawn exactly once
+vector<size_t> sampleDistinct(size_t populationSize, size_t count, mt19937 &engine);
+
+// Points of [minCoord, maxCoord]^2 at least minDistance apart, added by Bridson's algorithm until no more fit
+vector<pair<double, double>> samplePoissonDisk(double minCoord, double maxCoord, double minDistance,
+                                               mt19937 &engine);
@@ -0,0 +1,110 @@
+#include "PngStreamWriter.h"
+#include <stdexcept>
+#include <string>
+
+using std::runtime_error;
+using std::to_string;
+
+// Compressed bytes per IDAT chunk
+const size_t idatSize = 1u << 16u;
+
+void writeBigEndian(uint8_t *bytes, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    bytes[i] = uint8_t(value >> (24 - 8 * i));
+  }
+}
+
+PngStreamWriter::PngStreamWriter(ostream &out, unsigned width, unsigned height, int compressionLevel)
+    : out(out), width(width), height(height), filteredRow(size_t(width) * 4 + 1), compressed(idatSize) {
+  if (width == 0 || height == 0) {
+    throw runtime_error("An image needs at least one pixel");
+  }
+  if (deflateInit(&stream, compressionLevel) != Z_OK) {
+    throw runtime_error("Unable to start deflating an image");
+  }
+
+  const uint8_t signature[] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+  out.write(reinterpret_cast<const char *>(signature), sizeof signature);
+  // Width, height, 8 bits a channel, RGBA, deflate, adaptive filtering, no interlacing
+  uint8_t header[13] = {};
+  writeBigEndian(header, width);
+  writeBigEndian(header + 4, height);
+  header[8] = 8;
+  header[9] = 6;
+  writeChunk("IHDR", header, sizeof header);
+
+  stream.next_out = compressed.data();
+  stream.avail_out = uInt(compressed.size());
+}
+
+PngStreamWriter::~PngStreamWriter() {
+  deflateEnd(&stream);
+}
+
+void PngStreamWriter::writeChunk(const char *type, const uint8_t *data, size_t size) {
+  uint8_t length[4], crc[4];
+  writeBigEndian(length, uint32_t(size));
+  auto checksum = crc32(0, reinterpret_cast<const Bytef *>(type), 4);
+  if (size != 0) {
+    checksum = crc32(checksum, data, uInt(size));
+  }
+  writeBigEndian(crc, uint32_t(checksum));
+
+  out.write(reinterpret_cast<const char *>(length), 4);
+  out.write(type, 4);
+  out.write(reinterpret_cast<const char *>(data), std::streamsize(size));
+  out.write(reinterpret_cast<const char *>(crc), 4);
+  if (!out) {
+    throw runtime_error("Unable to write an image");
+  }
+}
+
+void PngStreamWriter::deflateInput(int flush) {
+  while (true) {
+    auto result = deflate(&stream, flush);
+    if (result == Z_STREAM_ERROR) {
+      throw runtime_error("Unable to deflate an image");
+    }
+    if (stream.avail_out == 0) {
+      writeChunk("IDAT", compressed.data(), compressed.size());
+      stream.next_out = compressed.data();
+      stream.avail_out = uInt(compressed.size());
+      continue;
+    }
+    // Room left in the buffer means deflate took all the input, or finished the stream
+    if (flush != Z_FINISH || result == Z_STREAM_END) {
+      return;
+    }
+  }
+}
+
+void PngStreamWriter::writeRow(const uint8_t *pixels) {
+  if (numberOfRows == height) {
+    throw runtime_error("More rows than the height of the image");
+  }
+  // Sub filter: the difference with the pixel to the left, which deflate packs well on flat backgrounds
+  size_t rowSize = size_t(width) * 4;
+  filteredRow[0] = 1;
+  for (size_t i = 0; i < 4; ++i) {
+    filteredRow[i + 1] = pixels[i];
+  }
+  for (size_t i = 4; i < rowSize; ++i) {
+    filteredRow[i + 1] = uint8_t(pixels[i] - pixels[i - 4]);
+  }
+
+  stream.next_in = filteredRow.data();
+  stream.avail_in = uInt(filteredRow.size());
+  deflateInput(Z_NO_FLUSH);
+  ++numberOfRows;
+}
+
+void PngStreamWriter::finish() {
+  if (numberOfRows != height) {
+    throw runtime_error("Image ended after " + to_string(numberOfRows) + " of " + to_string(height) + " rows");
+  }
+  stream.avail_in = 0;
+  deflateInput(Z_FINISH);
+  writeChunk("IDAT", compressed.data(), compressed.size() - stream.avail_out);
+  writeChunk("IEND", nullptr, 0);
+  out.flush();
+}
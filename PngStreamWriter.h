@@ -0,0 +1,41 @@
+#pragma once
+
+#include <zlib.h>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using std::ostream;
+using std::vector;
+
+// Writes an RGBA PNG with 8 bits a channel row by row. Every row is filtered and deflated as it comes, full buffers
+// of compressed bytes go out as IDAT chunks, so the image is never held whole.
+class PngStreamWriter {
+  ostream &out;
+  unsigned width, height;
+  unsigned numberOfRows = 0;
+  z_stream stream{};
+  // Filter type byte and the filtered row, the compressed bytes not written yet
+  vector<uint8_t> filteredRow, compressed;
+
+  void writeChunk(const char *type, const uint8_t *data, size_t size);
+
+  // Deflates the input of the stream, writing every full buffer
+  void deflateInput(int flush);
+
+public:
+  // Writes the signature and the header
+  PngStreamWriter(ostream &out, unsigned width, unsigned height, int compressionLevel = Z_BEST_SPEED);
+
+  PngStreamWriter(const PngStreamWriter &other) = delete;
+
+  PngStreamWriter &operator=(const PngStreamWriter &other) = delete;
+
+  ~PngStreamWriter();
+
+  // Four bytes a pixel, width pixels
+  void writeRow(const uint8_t *pixels);
+
+  // Ends the image after the last row
+  void finish();
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+enum class RenderBackend {
+  // Through a render texture, which needs a GL context
+  OpenGL,
+  // By SoftwareRasterizer on the CPU
+  Software
+};
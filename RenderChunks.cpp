@@ -0,0 +1,217 @@
+#include "RenderChunks.h"
+#include "Link.h"
+#include "TextFactory.h"
+#include <cmath>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+void RenderChunks::reset(const GraphCore &core) {
+  vector<GraphCore::NodeId> nodes(core.getNumberOfNodes());
+  for (GraphCore::NodeId i = 0; i < nodes.size(); ++i) {
+    nodes[i] = i;
+  }
+  vector<size_t> links(core.getNumberOfLinks());
+  for (size_t i = 0; i < links.size(); ++i) {
+    links[i] = i;
+  }
+  split(core, nodes, links);
+}
+
+void RenderChunks::reset(const GraphCore &core, const vector<size_t> &nodes, const vector<size_t> &links) {
+  split(core, vector<GraphCore::NodeId>(nodes.begin(), nodes.end()), links);
+}
+
+void RenderChunks::clear() {
+  chunks.clear();
+  numberOfDrawnChunks = 0;
+}
+
+void RenderChunks::split(const GraphCore &core, const vector<GraphCore::NodeId> &nodes, const vector<size_t> &links) {
+  clear();
+  if (nodes.empty()) {
+    return;
+  }
+
+  double minX = core.getX(nodes[0]), maxX = minX, minY = core.getY(nodes[0]), maxY = minY;
+  for (auto node:nodes) {
+    minX = min(minX, core.getX(node));
+    maxX = max(maxX, core.getX(node));
+    minY = min(minY, core.getY(node));
+    maxY = max(maxY, core.getY(node));
+  }
+  // Square cells, as many as chunks of nodesPerChunk would fill the bounding square
+  auto cellsPerSide = size_t(std::ceil(std::sqrt(double(nodes.size()) / double(nodesPerChunk))));
+  double cellSize = max(max(maxX - minX, maxY - minY) / double(cellsPerSide), 1e-9);
+  auto columns = size_t((maxX - minX) / cellSize) + 1, rows = size_t((maxY - minY) / cellSize) + 1;
+
+  vector<size_t> nodeCells(core.getNumberOfNodes());
+  vector<Chunk> cells(columns * rows);
+  for (auto node:nodes) {
+    auto column = min(size_t((core.getX(node) - minX) / cellSize), columns - 1);
+    auto row = min(size_t((core.getY(node) - minY) / cellSize), rows - 1);
+    auto &cell = cells[row * columns + column];
+    if (cell.nodes.empty()) {
+      cell.left = cell.right = float(core.getX(node));
+      cell.top = cell.bottom = float(core.getY(node));
+    }
+    cell.nodes.push_back(node);
+    cell.left = min(cell.left, float(core.getX(node)));
+    cell.right = max(cell.right, float(core.getX(node)));
+    cell.top = min(cell.top, float(core.getY(node)));
+    cell.bottom = max(cell.bottom, float(core.getY(node)));
+    cell.longestName = max(cell.longestName, core.getName(node).size());
+    nodeCells[node] = row * columns + column;
+  }
+  for (auto link:links) {
+    auto[first, second] = core.getLink(link);
+    auto &cell = cells[nodeCells[first]];
+    cell.links.push_back(link);
+    cell.left = min(cell.left, float(core.getX(second)));
+    cell.right = max(cell.right, float(core.getX(second)));
+    cell.top = min(cell.top, float(core.getY(second)));
+    cell.bottom = max(cell.bottom, float(core.getY(second)));
+  }
+
+  for (auto &cell:cells) {
+    if (!cell.nodes.empty()) {
+      chunks.push_back(std::move(cell));
+    }
+  }
+}
+
+bool RenderChunks::isStale() const {
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto &textFactory = TextFactory::getTextFactory();
+  return discsRadius != nodeSettings.radius || pointsColor != nodeSettings.color ||
+         labelsCharacterSize != textFactory.getCharacterSize() || labelsColor != textFactory.getCharacterColor();
+}
+
+void RenderChunks::dropStaleVertices() {
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto &textFactory = TextFactory::getTextFactory();
+  bool areDiscsStale = discsRadius != nodeSettings.radius, arePointsStale = pointsColor != nodeSettings.color;
+  bool areLabelsStale =
+      labelsCharacterSize != textFactory.getCharacterSize() || labelsColor != textFactory.getCharacterColor();
+  for (auto &chunk:chunks) {
+    if (areDiscsStale) {
+      chunk.discs.clear();
+      chunk.hasDiscs = false;
+    }
+    if (arePointsStale) {
+      chunk.points.clear();
+      chunk.hasPoints = false;
+    }
+    if (areLabelsStale) {
+      chunk.labels.clear();
+      chunk.hasLabels = false;
+    }
+  }
+  discsRadius = nodeSettings.radius;
+  pointsColor = nodeSettings.color;
+  labelsCharacterSize = textFactory.getCharacterSize();
+  labelsColor = textFactory.getCharacterColor();
+}
+
+void RenderChunks::draw(const GraphCore &core, sf::RenderTarget &target, sf::RenderStates states,
+                        DiscTexture &discTexture) {
+  dropStaleVertices();
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto &textFactory = TextFactory::getTextFactory();
+
+  const auto &view = target.getView();
+  // Pixels of the target per unit of the view
+  double scale = double(target.getSize().x) / double(view.getSize().x);
+  bool showDiscs = 2 * nodeSettings.radius * scale >= nodeSettings.minimumDiscPixels;
+  bool showLabels = double(labelsCharacterSize) * scale >= nodeSettings.minimumLabelPixels;
+  bool showLinkTriangles = Link::width * scale >= 1;
+
+  float viewLeft = view.getCenter().x - view.getSize().x / 2, viewRight = view.getCenter().x + view.getSize().x / 2;
+  float viewTop = view.getCenter().y - view.getSize().y / 2, viewBottom = view.getCenter().y + view.getSize().y / 2;
+  vector<Chunk *> visibleChunks;
+  for (auto &chunk:chunks) {
+    // Discs, link ends and labels centred at the nodes stick out of the bounds
+    auto margin = float(max(max(nodeSettings.radius, Link::width) + 1,
+                            showLabels ? double(chunk.longestName * labelsCharacterSize) / 2 : 0.));
+    if (chunk.right + margin >= viewLeft && chunk.left - margin <= viewRight && chunk.bottom + margin >= viewTop &&
+        chunk.top - margin <= viewBottom) {
+      visibleChunks.push_back(&chunk);
+    }
+  }
+  numberOfDrawnChunks = visibleChunks.size();
+
+  // Links of all chunks go first, so that no link of one chunk is drawn over a node of another
+  for (auto chunk:visibleChunks) {
+    if (showLinkTriangles) {
+      if (!chunk->hasLinkTriangles) {
+        for (auto link:chunk->links) {
+          auto[first, second] = core.getLink(link);
+          Link(core.getX(first), core.getY(first), core.getX(second), core.getY(second))
+              .appendTriangles(chunk->linkTriangles);
+        }
+        chunk->hasLinkTriangles = true;
+      }
+      target.draw(chunk->linkTriangles, states);
+    } else {
+      if (!chunk->hasLinkLines) {
+        for (auto link:chunk->links) {
+          auto[first, second] = core.getLink(link);
+          for (auto node:{first, second}) {
+            sf::Vector2f position(float(core.getX(node)), float(core.getY(node)));
+            chunk->linkLines.append(sf::Vertex(position, Link::color));
+          }
+        }
+        chunk->hasLinkLines = true;
+      }
+      target.draw(chunk->linkLines, states);
+    }
+  }
+
+  auto discStates = states;
+  if (showDiscs) {
+    discStates.texture = &discTexture.getTexture();
+  }
+  for (auto chunk:visibleChunks) {
+    if (showDiscs) {
+      if (!chunk->hasDiscs) {
+        for (auto node:chunk->nodes) {
+          Node::appendDisc(chunk->discs, core.getX(node), core.getY(node));
+        }
+        chunk->hasDiscs = true;
+      }
+      target.draw(chunk->discs, discStates);
+    } else {
+      if (!chunk->hasPoints) {
+        for (auto node:chunk->nodes) {
+          chunk->points.append(sf::Vertex(sf::Vector2f(float(core.getX(node)), float(core.getY(node))), pointsColor));
+        }
+        chunk->hasPoints = true;
+      }
+      target.draw(chunk->points, states);
+    }
+  }
+
+  if (!showLabels) {
+    return;
+  }
+  auto labelStates = states;
+  labelStates.texture = &textFactory.getTexture();
+  for (auto chunk:visibleChunks) {
+    if (!chunk->hasLabels) {
+      for (auto node:chunk->nodes) {
+        textFactory.appendText(chunk->labels, core.getName(node), core.getX(node), core.getY(node));
+      }
+      chunk->hasLabels = true;
+    }
+    target.draw(chunk->labels, labelStates);
+  }
+}
+
+size_t RenderChunks::getNumberOfChunks() const {
+  return chunks.size();
+}
+
+size_t RenderChunks::getNumberOfDrawnChunks() const {
+  return numberOfDrawnChunks;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "GraphCore.h"
+#include "DiscTexture.h"
+#include <SFML/Graphics.hpp>
+
+using std::vector;
+
+// Drawn graph split by a uniform grid into chunks of about nodesPerChunk nodes, so only the chunks in the view are
+// drawn. A link belongs to the chunk of its first node. Vertices of a chunk are built on the first draw that shows
+// it at their level of detail: discs or points for nodes, triangles or lines for links, labels or nothing.
+class RenderChunks {
+  struct Chunk {
+    vector<GraphCore::NodeId> nodes;
+    vector<size_t> links;
+    // Of the nodes and the links, without the discs and labels around them
+    float left = 0, top = 0, right = 0, bottom = 0;
+    size_t longestName = 0;
+
+    sf::VertexArray linkTriangles{sf::Triangles}, linkLines{sf::Lines};
+    sf::VertexArray discs{sf::Triangles}, points{sf::Points}, labels{sf::Triangles};
+    bool hasLinkTriangles = false, hasLinkLines = false, hasDiscs = false, hasPoints = false, hasLabels = false;
+  };
+
+  vector<Chunk> chunks;
+  size_t numberOfDrawnChunks = 0;
+
+  // Settings the built discs, points and labels were made with
+  double discsRadius = 0;
+  sf::Color pointsColor;
+  size_t labelsCharacterSize = 0;
+  sf::Color labelsColor;
+
+  void split(const GraphCore &core, const vector<GraphCore::NodeId> &nodes, const vector<size_t> &links);
+
+  // Drops vertices made with settings that changed since
+  void dropStaleVertices();
+
+public:
+  static constexpr size_t nodesPerChunk = 1024;
+
+  // All nodes and links of the core
+  void reset(const GraphCore &core);
+
+  void reset(const GraphCore &core, const vector<size_t> &nodes, const vector<size_t> &links);
+
+  void clear();
+
+  // Whether the settings of nodes or labels changed since the vertices were built
+  [[nodiscard]] bool isStale() const;
+
+  // Chunks out of the view of the target are skipped, the level of detail follows the pixels per unit of the view.
+  // Discs show the disc texture of the context of the target.
+  void draw(const GraphCore &core, sf::RenderTarget &target, sf::RenderStates states, DiscTexture &discTexture);
+
+  [[nodiscard]] size_t getNumberOfChunks() const;
+
+  // In the last draw
+  [[nodiscard]] size_t getNumberOfDrawnChunks() const;
+};
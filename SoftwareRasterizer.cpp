@@ -0,0 +1,305 @@
+#include "SoftwareRasterizer.h"
+#include "Link.h"
+#include "TextFactory.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <cstring>
+
+using std::min;
+using std::max;
+using std::thread;
+using std::numeric_limits;
+
+SoftwareRasterizer::SoftwareRasterizer(unsigned width, unsigned height)
+    : width(width), height(height), pixels(size_t(width) * height, 0),
+      view(sf::FloatRect(0, 0, float(width), float(height))) {}
+
+void SoftwareRasterizer::setView(const sf::View &newView) {
+  view = newView;
+}
+
+const sf::View &SoftwareRasterizer::getView() const {
+  return view;
+}
+
+// RGBA bytes of the color in the order they have in memory
+static uint32_t packColor(sf::Color color) {
+  uint8_t bytes[] = {color.r, color.g, color.b, color.a};
+  uint32_t packed;
+  std::memcpy(&packed, bytes, sizeof(packed));
+  return packed;
+}
+
+void SoftwareRasterizer::clear(sf::Color color) {
+  std::fill(pixels.begin(), pixels.end(), packColor(color));
+}
+
+unsigned SoftwareRasterizer::getWidth() const {
+  return width;
+}
+
+unsigned SoftwareRasterizer::getHeight() const {
+  return height;
+}
+
+const uint8_t *SoftwareRasterizer::getPixels() const {
+  return reinterpret_cast<const uint8_t *>(pixels.data());
+}
+
+sf::Image SoftwareRasterizer::copyToImage() const {
+  sf::Image image;
+  image.create(width, height, getPixels());
+  return image;
+}
+
+void SoftwareRasterizer::blendSpan(unsigned row, unsigned column, const uint8_t *coverage, size_t count,
+                                   sf::Color color) {
+  // Source over without branches, two channels of a pixel in every 32 bits, dividing by 255 with shifts, so that
+  // the compiler fills several pixels an instruction. Blending an opaque alpha in keeps the alpha of the result.
+  auto *target = pixels.data() + size_t(row) * width + column;
+  auto source = packColor(sf::Color(color.r, color.g, color.b, 255));
+  uint32_t sourceLow = source & 0xFF00FFu, sourceHigh = (source >> 8u) & 0xFF00FFu, opacity = color.a;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t scaled = coverage[i] * opacity + 128;
+    uint32_t alpha = (scaled + (scaled >> 8u)) >> 8u, rest = 255 - alpha;
+    uint32_t low = sourceLow * alpha + (target[i] & 0xFF00FFu) * rest + 0x800080u;
+    uint32_t high = sourceHigh * alpha + ((target[i] >> 8u) & 0xFF00FFu) * rest + 0x800080u;
+    low = ((low + ((low >> 8u) & 0xFF00FFu)) >> 8u) & 0xFF00FFu;
+    high = ((high + ((high >> 8u) & 0xFF00FFu)) >> 8u) & 0xFF00FFu;
+    target[i] = low | high << 8u;
+  }
+}
+
+// Coverage of a pixel by a shape whose edge is distance pixels away from its centre, positive inside
+static inline float edgeCoverage(float distance) {
+  return min(max(distance + .5f, 0.f), 1.f);
+}
+
+void SoftwareRasterizer::fillSegment(const Segment &segment, float halfWidth, sf::Color color, unsigned firstRow,
+                                     unsigned lastRow, vector<uint8_t> &coverage) {
+  float dx = segment.x2 - segment.x1, dy = segment.y2 - segment.y1, length = std::hypot(dx, dy);
+  if (length == 0) {
+    return;
+  }
+  float ux = dx / length, uy = dy / length;
+  // The smoothed edge reaches a pixel beyond the rectangle
+  float reach = halfWidth + 1;
+
+  // Rows come from the part of the centre line within reach of the band (Liang-Barsky clipping), so that links
+  // passing far outside of it cost nothing
+  float from = 0, to = 1;
+  float bounds[][2] = {{-dx, segment.x1 + reach}, {dx, float(width) + reach - segment.x1},
+                       {-dy, segment.y1 - float(firstRow) + reach}, {dy, float(lastRow) + reach - segment.y1}};
+  for (const auto &bound:bounds) {
+    float direction = bound[0], room = bound[1];
+    if (direction == 0 && room < 0) {
+      return;
+    }
+    if (direction < 0) {
+      from = max(from, room / direction);
+    } else if (direction > 0) {
+      to = min(to, room / direction);
+    }
+  }
+  if (from > to) {
+    return;
+  }
+  float top = min(segment.y1 + from * dy, segment.y1 + to * dy) - reach - 1;
+  float bottom = max(segment.y1 + from * dy, segment.y1 + to * dy) + reach + 1;
+  // Columns of a row come from |across| <= reach and -1 <= along <= length + 1, both linear in x along the row
+  float acrossScale = std::fabs(uy) > 1e-6f ? 1 / uy : 0, alongScale = std::fabs(ux) > 1e-6f ? 1 / ux : 0;
+
+  auto rowBegin = unsigned(max(std::floor(top), float(firstRow)));
+  auto rowEnd = unsigned(max(min(std::ceil(bottom), float(lastRow)), float(rowBegin)));
+  for (auto row = rowBegin; row < rowEnd; ++row) {
+    // Columns for the top and the bottom of the row, the range between them holds the columns of any y inside
+    float left = numeric_limits<float>::max(), right = numeric_limits<float>::lowest();
+    for (auto y:{float(row), float(row + 1)}) {
+      float py = y - segment.y1;
+      float low = -numeric_limits<float>::max(), high = numeric_limits<float>::max();
+      if (acrossScale != 0) {
+        float a = (py * ux - reach) * acrossScale, b = (py * ux + reach) * acrossScale;
+        low = max(low, min(a, b));
+        high = min(high, max(a, b));
+      }
+      if (alongScale != 0) {
+        float a = (-1 - py * uy) * alongScale, b = (length + 1 - py * uy) * alongScale;
+        low = max(low, min(a, b));
+        high = min(high, max(a, b));
+      }
+      left = min(left, low);
+      right = max(right, high);
+    }
+    left += segment.x1;
+    right += segment.x1;
+    if (left > right) {
+      continue;
+    }
+    auto columnBegin = unsigned(min(max(std::floor(left), 0.f), float(width)));
+    auto columnEnd = unsigned(min(max(std::ceil(right), 0.f), float(width)));
+    if (columnBegin >= columnEnd) {
+      continue;
+    }
+
+    size_t count = columnEnd - columnBegin;
+    coverage.resize(count);
+    float py = float(row) + .5f - segment.y1;
+    for (size_t i = 0; i < count; ++i) {
+      float px = float(columnBegin + i) + .5f - segment.x1;
+      float along = px * ux + py * uy, across = std::fabs(px * uy - py * ux);
+      float share = edgeCoverage(halfWidth - across) * edgeCoverage(min(along, length - along));
+      coverage[i] = uint8_t(share * 255 + .5f);
+    }
+    blendSpan(row, columnBegin, coverage.data(), count, color);
+  }
+}
+
+void SoftwareRasterizer::fillDisc(const Disc &disc, float radius, sf::Color color, unsigned firstRow,
+                                  unsigned lastRow, vector<uint8_t> &coverage) {
+  float reach = radius + 1;
+  auto rowBegin = unsigned(max(std::floor(disc.y - reach), float(firstRow)));
+  auto rowEnd = unsigned(max(min(std::ceil(disc.y + reach), float(lastRow)), float(rowBegin)));
+  for (auto row = rowBegin; row < rowEnd; ++row) {
+    float dy = float(row) + .5f - disc.y;
+    float halfChord = std::sqrt(max(reach * reach - dy * dy, 0.f));
+    auto columnBegin = unsigned(min(max(std::floor(disc.x - halfChord), 0.f), float(width)));
+    auto columnEnd = unsigned(min(max(std::ceil(disc.x + halfChord), 0.f), float(width)));
+    if (columnBegin >= columnEnd) {
+      continue;
+    }
+
+    size_t count = columnEnd - columnBegin;
+    coverage.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      float dx = float(columnBegin + i) + .5f - disc.x;
+      coverage[i] = uint8_t(edgeCoverage(radius - std::sqrt(dx * dx + dy * dy)) * 255 + .5f);
+    }
+    blendSpan(row, columnBegin, coverage.data(), count, color);
+  }
+}
+
+void SoftwareRasterizer::drawGlyph(const PlacedGlyph &placed, sf::Color color, unsigned firstRow, unsigned lastRow) {
+  const auto &glyph = *placed.glyph;
+  int columnBegin = max(placed.left, 0), columnEnd = min(placed.left + glyph.width, int(width));
+  int rowBegin = max(placed.top, int(firstRow)), rowEnd = min(placed.top + glyph.height, int(lastRow));
+  if (columnBegin >= columnEnd) {
+    return;
+  }
+  for (int row = rowBegin; row < rowEnd; ++row) {
+    const auto *coverage = glyph.coverage.data() + size_t(row - placed.top) * glyph.width + (columnBegin - placed.left);
+    blendSpan(unsigned(row), unsigned(columnBegin), coverage, size_t(columnEnd - columnBegin), color);
+  }
+}
+
+void SoftwareRasterizer::placeText(vector<PlacedGlyph> &placed, const GlyphBitmaps &bitmaps, const string &text,
+                                   unsigned characterSize, float x, float y) {
+  if (text.empty()) {
+    return;
+  }
+  float whitespaceWidth = bitmaps.getGlyph(' ', characterSize).advance;
+  float penX = 0;
+  float minX = numeric_limits<float>::max(), minY = minX, maxX = numeric_limits<float>::lowest(), maxY = maxX;
+  auto firstGlyph = placed.size();
+  vector<float> pens;
+  uint32_t previous = 0;
+  for (auto character:text) {
+    uint32_t current = static_cast<unsigned char>(character);
+    penX += bitmaps.getKerning(previous, current, characterSize);
+    previous = current;
+    if (current == ' ' || current == '\t') {
+      minX = min(minX, penX);
+      minY = min(minY, 0.f);
+      penX += current == ' ' ? whitespaceWidth : 4 * whitespaceWidth;
+      maxX = max(maxX, penX);
+      maxY = max(maxY, 0.f);
+      continue;
+    }
+
+    const auto &glyph = bitmaps.getGlyph(current, characterSize);
+    minX = min(minX, penX + glyph.boundsLeft);
+    minY = min(minY, glyph.boundsTop);
+    maxX = max(maxX, penX + glyph.boundsLeft + glyph.boundsWidth);
+    maxY = max(maxY, glyph.boundsTop + glyph.boundsHeight);
+    placed.push_back({&glyph, 0, 0});
+    pens.push_back(penX);
+    penX += glyph.advance;
+  }
+
+  // The bitmap is where sf::Text puts the quad of the glyph, at the bounds of its outline
+  float offsetX = x - (minX + maxX) / 2, offsetY = y - (minY + maxY) / 2;
+  for (auto i = firstGlyph; i < placed.size(); ++i) {
+    const auto &glyph = *placed[i].glyph;
+    placed[i].left = int(std::lround(offsetX + pens[i - firstGlyph] + glyph.boundsLeft));
+    placed[i].top = int(std::lround(offsetY + glyph.boundsTop));
+  }
+}
+
+void SoftwareRasterizer::draw(const GraphCore &core, const vector<size_t> &nodes, const vector<size_t> &links,
+                              size_t numberOfThreads) {
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto &textFactory = TextFactory::getTextFactory();
+
+  // Pixels per unit of the view, the same along both axes as in Graph::draw
+  float scale = float(width) / view.getSize().x;
+  float originX = view.getCenter().x - view.getSize().x / 2, originY = view.getCenter().y - view.getSize().y / 2;
+  auto toPixelX = [scale, originX](double x) {
+    return (float(x) - originX) * scale;
+  };
+  auto toPixelY = [scale, originY](double y) {
+    return (float(y) - originY) * scale;
+  };
+
+  vector<Segment> segments;
+  segments.reserve(links.size());
+  for (auto link:links) {
+    auto[first, second] = core.getLink(link);
+    segments.push_back({toPixelX(core.getX(first)), toPixelY(core.getY(first)), toPixelX(core.getX(second)),
+                        toPixelY(core.getY(second))});
+  }
+  vector<Disc> discs;
+  discs.reserve(nodes.size());
+  for (auto node:nodes) {
+    discs.push_back({toPixelX(core.getX(node)), toPixelY(core.getY(node))});
+  }
+  // Glyph bitmaps are loaded here, so the bands only read them
+  vector<PlacedGlyph> glyphs;
+  auto characterSize = unsigned(std::lround(double(textFactory.getCharacterSize()) * scale));
+  if (double(characterSize) >= nodeSettings.minimumLabelPixels) {
+    const auto &bitmaps = textFactory.getGlyphBitmaps();
+    for (auto node:nodes) {
+      placeText(glyphs, bitmaps, core.getName(node), characterSize, toPixelX(core.getX(node)),
+                toPixelY(core.getY(node)));
+    }
+  }
+
+  auto halfWidth = float(Link::width / 2 * scale), radius = float(nodeSettings.radius * scale);
+  auto nodeColor = nodeSettings.color, labelColor = textFactory.getCharacterColor();
+  auto drawBand = [&](unsigned firstRow, unsigned lastRow) {
+    vector<uint8_t> coverage;
+    for (const auto &segment:segments) {
+      fillSegment(segment, halfWidth, Link::color, firstRow, lastRow, coverage);
+    }
+    for (const auto &disc:discs) {
+      fillDisc(disc, radius, nodeColor, firstRow, lastRow, coverage);
+    }
+    for (const auto &glyph:glyphs) {
+      drawGlyph(glyph, labelColor, firstRow, lastRow);
+    }
+  };
+
+  numberOfThreads = max(min(numberOfThreads, size_t(height)), size_t(1));
+  if (numberOfThreads == 1) {
+    drawBand(0, height);
+    return;
+  }
+  // Bands share no pixels, so threads draw them without locks
+  vector<thread> bands;
+  for (size_t i = 0; i < numberOfThreads; ++i) {
+    bands.emplace_back(drawBand, unsigned(height * i / numberOfThreads), unsigned(height * (i + 1) / numberOfThreads));
+  }
+  for (auto &band:bands) {
+    band.join();
+  }
+}
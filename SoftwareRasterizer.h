@@ -0,0 +1,69 @@
+#pragma once
+
+#include "GraphCore.h"
+#include "GlyphBitmaps.h"
+#include "RenderBackend.h"
+#include <SFML/Graphics.hpp>
+
+using std::vector;
+
+// Draws graphs into an RGBA buffer on the CPU, for machines without a GL context. Links, discs and labels are placed
+// as Graph::draw places them, their edges are smoothed by the share of every pixel they cover. Rows of the image can
+// be split into bands drawn by threads of their own.
+class SoftwareRasterizer {
+  // Shapes in pixels of the image
+  struct Segment {
+    float x1, y1, x2, y2;
+  };
+  struct Disc {
+    float x, y;
+  };
+  struct PlacedGlyph {
+    const GlyphBitmaps::Glyph *glyph;
+    int left, top;
+  };
+
+  unsigned width, height;
+  // RGBA bytes of a pixel in one word
+  vector<uint32_t> pixels;
+  sf::View view;
+
+  // Blends color into count pixels from (column, row), each weighted by its coverage from 0 to 255
+  void blendSpan(unsigned row, unsigned column, const uint8_t *coverage, size_t count, sf::Color color);
+
+  void fillSegment(const Segment &segment, float halfWidth, sf::Color color, unsigned firstRow, unsigned lastRow,
+                   vector<uint8_t> &coverage);
+
+  void fillDisc(const Disc &disc, float radius, sf::Color color, unsigned firstRow, unsigned lastRow,
+                vector<uint8_t> &coverage);
+
+  void drawGlyph(const PlacedGlyph &placed, sf::Color color, unsigned firstRow, unsigned lastRow);
+
+  // Glyphs of the text centred at (x, y) as TextFactory::appendText lays them out
+  static void placeText(vector<PlacedGlyph> &placed, const GlyphBitmaps &bitmaps, const string &text,
+                        unsigned characterSize, float x, float y);
+
+public:
+  // Cleared to transparent, with the default view of a render texture of the size
+  SoftwareRasterizer(unsigned width, unsigned height);
+
+  void setView(const sf::View &newView);
+
+  [[nodiscard]] const sf::View &getView() const;
+
+  void clear(sf::Color color);
+
+  // Links, then discs, then labels of the listed nodes and links, the labels as far as their size is above
+  // NodeSettings::minimumLabelPixels
+  void draw(const GraphCore &core, const vector<size_t> &nodes, const vector<size_t> &links,
+            size_t numberOfThreads = 1);
+
+  [[nodiscard]] unsigned getWidth() const;
+
+  [[nodiscard]] unsigned getHeight() const;
+
+  // Four bytes a pixel, row by row
+  [[nodiscard]] const uint8_t *getPixels() const;
+
+  [[nodiscard]] sf::Image copyToImage() const;
+};
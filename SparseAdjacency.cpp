@@ -0,0 +1,92 @@
+#include "SparseAdjacency.h"
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using std::swap;
+using std::out_of_range;
+using std::to_string;
+
+SparseAdjacency::SparseAdjacency() {
+  reset(0, 0);
+}
+
+uint64_t SparseAdjacency::getKey(size_t i, size_t j) {
+  if (i < j) {
+    swap(i, j);
+  }
+  return uint64_t(i) << 32u | uint64_t(j);
+}
+
+size_t SparseAdjacency::findSlot(uint64_t key) const {
+  // Fibonacci hashing spreads keys of neighbouring nodes over the table, probing is linear
+  size_t mask = slots.size() - 1;
+  size_t slot = size_t((key * 0x9e3779b97f4a7c15ull) >> shift);
+  while (slots[slot] != emptySlot && slots[slot] != key) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void SparseAdjacency::rehash(size_t capacity) {
+  vector<uint64_t> oldSlots(capacity, emptySlot);
+  oldSlots.swap(slots);
+  shift = 64;
+  for (size_t size = capacity; size > 1; size >>= 1u) {
+    --shift;
+  }
+  for (auto key:oldSlots) {
+    if (key != emptySlot) {
+      slots[findSlot(key)] = key;
+    }
+  }
+}
+
+void SparseAdjacency::reset(size_t numberOfNodes, size_t expectedLinks) {
+  if (numberOfNodes > (size_t(1) << 32u)) {
+    throw out_of_range(to_string(numberOfNodes) + " nodes do not fit into keys of sparse adjacency");
+  }
+  n = numberOfNodes;
+  numberOfLinks = 0;
+
+  // At most half of the slots are used
+  size_t capacity = 16;
+  while (capacity < 2 * expectedLinks) {
+    capacity <<= 1u;
+  }
+  slots.clear();
+  rehash(capacity);
+}
+
+size_t SparseAdjacency::getDimension() const {
+  return n;
+}
+
+size_t SparseAdjacency::getNumberOfLinks() const {
+  return numberOfLinks;
+}
+
+bool SparseAdjacency::contains(size_t i, size_t j) const {
+  return slots[findSlot(getKey(i, j))] != emptySlot;
+}
+
+bool SparseAdjacency::insert(size_t i, size_t j) {
+  if (i >= n || j >= n || i == j) {
+    throw out_of_range(to_string(i) + ", " + to_string(j) + " is not a link of sparse adjacency of " +
+                       to_string(n) + " dimension");
+  }
+  auto key = getKey(i, j);
+  auto slot = findSlot(key);
+  if (slots[slot] == key) {
+    return false;
+  }
+  slots[slot] = key;
+  if (2 * ++numberOfLinks > slots.size()) {
+    rehash(2 * slots.size());
+  }
+  return true;
+}
+
+size_t SparseAdjacency::getMemoryUsage() const {
+  return slots.capacity() * sizeof(uint64_t);
+}
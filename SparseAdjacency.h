@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using std::vector;
+
+// Set of links as 64-bit keys of their node pairs in an open addressing hash table, takes memory in proportion
+// to the number of links instead of the square of the number of nodes
+class SparseAdjacency {
+  static constexpr uint64_t emptySlot = ~uint64_t(0);
+
+  size_t n = 0;
+  size_t numberOfLinks = 0;
+  vector<uint64_t> slots;
+  unsigned shift = 64;
+
+  [[nodiscard]] static uint64_t getKey(size_t i, size_t j);
+
+  // Slot holding the key or the empty slot where it would go
+  [[nodiscard]] size_t findSlot(uint64_t key) const;
+
+  void rehash(size_t capacity);
+
+public:
+  // No nodes, with the smallest table, so lookups work before the first reset
+  SparseAdjacency();
+
+  void reset(size_t numberOfNodes, size_t expectedLinks);
+
+  [[nodiscard]] size_t getDimension() const;
+
+  [[nodiscard]] size_t getNumberOfLinks() const;
+
+  [[nodiscard]] bool contains(size_t i, size_t j) const;
+
+  // Returns false if the link was already there
+  bool insert(size_t i, size_t j);
+
+  [[nodiscard]] size_t getMemoryUsage() const;
+};
@@ -0,0 +1,57 @@
+#include "SpatialGrid.h"
+#include <cmath>
+
+using std::min;
+using std::max;
+
+void SpatialGrid::reset(double newMinX, double newMinY, double maxX, double maxY, double newCellSize) {
+  minX = newMinX;
+  minY = newMinY;
+  cellSize = newCellSize;
+  columns = size_t((maxX - minX) / cellSize) + 1;
+  rows = size_t((maxY - minY) / cellSize) + 1;
+
+  nodeCells.assign(columns * rows, vector<size_t>());
+  linkCells.assign(columns * rows, vector<size_t>());
+}
+
+void SpatialGrid::clear() {
+  columns = rows = 0;
+  nodeCells.clear();
+  linkCells.clear();
+}
+
+bool SpatialGrid::empty() const {
+  return columns == 0;
+}
+
+size_t SpatialGrid::getColumn(double x) const {
+  double column = std::floor((x - minX) / cellSize);
+  if (column < 0) {
+    return 0;
+  }
+  return min(size_t(column), columns - 1);
+}
+
+size_t SpatialGrid::getRow(double y) const {
+  double row = std::floor((y - minY) / cellSize);
+  if (row < 0) {
+    return 0;
+  }
+  return min(size_t(row), rows - 1);
+}
+
+size_t SpatialGrid::getRingCount() const {
+  return max(columns, rows);
+}
+
+void SpatialGrid::insertNode(size_t index, double x, double y) {
+  nodeCells[getRow(y) * columns + getColumn(x)].push_back(index);
+}
+
+void SpatialGrid::insertLink(size_t index, double x1, double y1, double x2, double y2) {
+  anyCellAlong(x1, y1, x2, y2, cellPadding, [this, index](size_t cell) {
+    linkCells[cell].push_back(index);
+    return false;
+  });
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+using std::vector;
+
+// Uniform grid over the plane. Nodes are stored in the single cell containing them, links in every cell their
+// segment crosses, so segment queries only touch elements in the neighbourhood of the segment.
+class SpatialGrid {
+  // Keeps rounding in the intersection tests from slipping through cell borders
+  static constexpr double cellPadding = 1e-6;
+
+  double minX = 0, minY = 0;
+  double cellSize = 1;
+  size_t columns = 0, rows = 0;
+  vector<vector<size_t>> nodeCells;
+  vector<vector<size_t>> linkCells;
+
+  [[nodiscard]] size_t getColumn(double x) const;
+
+  [[nodiscard]] size_t getRow(double y) const;
+
+  // Calls function for every cell within padding of the segment until it returns true
+  template<typename Function>
+  bool anyCellAlong(double x1, double y1, double x2, double y2, double padding, Function function) const;
+
+public:
+  void reset(double newMinX, double newMinY, double maxX, double maxY, double newCellSize);
+
+  void clear();
+
+  [[nodiscard]] bool empty() const;
+
+  void insertNode(size_t index, double x, double y);
+
+  void insertLink(size_t index, double x1, double y1, double x2, double y2);
+
+  // Number of rings around any cell needed to cover the whole grid
+  [[nodiscard]] size_t getRingCount() const;
+
+  // Calls function for nodes in cells at exactly ring cells distance from the cell containing the point
+  template<typename Function>
+  void forEachNodeInRing(double x, double y, size_t ring, Function function) const;
+
+  // Walks the cells along the segment and checks the predicates on the nodes of a cell, whose disc of given radius
+  // may touch the segment, and on its links, which may intersect it, stopping at the first match. Predicates get
+  // whole cells as vectors of indexes, a link may be in more than one of them.
+  template<typename NodesPredicate, typename LinksPredicate>
+  bool anyAlong(double x1, double y1, double x2, double y2, double radius, NodesPredicate nodesPredicate,
+                LinksPredicate linksPredicate) const;
+};
+
+template<typename Function>
+bool SpatialGrid::anyCellAlong(double x1, double y1, double x2, double y2, double padding, Function function) const {
+  if (x1 > x2) {
+    std::swap(x1, x2);
+    std::swap(y1, y2);
+  }
+
+  size_t firstColumn = getColumn(x1 - padding), lastColumn = getColumn(x2 + padding);
+  for (size_t column = firstColumn; column <= lastColumn; ++column) {
+    // Part of the segment whose points are at most padding away from the column
+    double left = x1, right = x2;
+    if (column > 0) {
+      left = std::max(left, minX + double(column) * cellSize - padding);
+    }
+    if (column + 1 < columns) {
+      right = std::min(right, minX + double(column + 1) * cellSize + padding);
+    }
+
+    double top, bottom;
+    if (x2 - x1 > 0) {
+      double slope = (y2 - y1) / (x2 - x1);
+      double leftY = y1 + (left - x1) * slope, rightY = y1 + (right - x1) * slope;
+      top = std::min(leftY, rightY);
+      bottom = std::max(leftY, rightY);
+    } else {
+      top = std::min(y1, y2);
+      bottom = std::max(y1, y2);
+    }
+
+    size_t firstRow = getRow(top - padding), lastRow = getRow(bottom + padding);
+    for (size_t row = firstRow; row <= lastRow; ++row) {
+      if (function(row * columns + column)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template<typename NodesPredicate, typename LinksPredicate>
+bool SpatialGrid::anyAlong(double x1, double y1, double x2, double y2, double radius, NodesPredicate nodesPredicate,
+                           LinksPredicate linksPredicate) const {
+  return anyCellAlong(x1, y1, x2, y2, radius + cellPadding, [&](size_t cell) {
+    return (!nodeCells[cell].empty() && nodesPredicate(nodeCells[cell])) ||
+           (!linkCells[cell].empty() && linksPredicate(linkCells[cell]));
+  });
+}
+
+template<typename Function>
+void SpatialGrid::forEachNodeInRing(double x, double y, size_t ring, Function function) const {
+  auto centerColumn = long(getColumn(x)), centerRow = long(getRow(y)), distance = long(ring);
+  for (long row = centerRow - distance; row <= centerRow + distance; ++row) {
+    if (row < 0 || row >= long(rows)) {
+      continue;
+    }
+    // Inner rows of the ring only have their leftmost and rightmost cells
+    long step = row == centerRow - distance || row == centerRow + distance ? 1 : 2 * distance;
+    for (long column = centerColumn - distance; column <= centerColumn + distance; column += step) {
+      if (column >= 0 && column < long(columns)) {
+        for (auto index:nodeCells[row * columns + column]) {
+          function(index);
+        }
+      }
+    }
+  }
+}
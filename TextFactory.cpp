@@ -3,11 +3,16 @@
 //
 
 #include "TextFactory.h"
-#include <fstream>
+#include <algorithm>
+#include <limits>
 
-using std::ifstream;
 using std::runtime_error;
 using std::make_unique;
+using std::min;
+using std::max;
+using std::numeric_limits;
+
+const string TextFactory::nameCharacters = "0123456789";
 
 TextFactory::TextFactory() = default;
 
@@ -17,19 +22,36 @@ TextFactory &TextFactory::getTextFactory() {
 }
 
 void TextFactory::loadFontFromFile(const string &path) {
-  fontData = make_unique<char[]>(1000000);
-
-  ifstream in(path);
-  if (!in) {
-    throw runtime_error("Unable to open file " + path);
+  if (fontFile && path == fontPath) {
+    return;
   }
+  auto file = make_unique<MappedFile>(path);
 
-  in.read(fontData.get(), 1000000);
-  size_t size = in.tellg();
-
-  if (!font.loadFromMemory(fontData.get(), size)) {
+  // The old bitmaps and font read the old file, which goes once the new font replaces them
+  glyphBitmaps.reset();
+  if (!font.loadFromMemory(file->data(), file->size())) {
+    fontFile.reset();
+    fontPath.clear();
     throw runtime_error("Unable to load font from file " + path);
   }
+  glyphBitmaps = make_unique<GlyphBitmaps>(file->data(), file->size());
+  fontFile = std::move(file);
+  fontPath = path;
+}
+
+void TextFactory::preloadGlyphs(const string &characters, RenderBackend backend) const {
+  if (!fontFile) {
+    return;
+  }
+  auto size = unsigned(characterSize);
+  for (auto character:characters) {
+    sf::Uint32 current = static_cast<unsigned char>(character);
+    if (backend == RenderBackend::OpenGL) {
+      font.getGlyph(current, size, false);
+    } else {
+      glyphBitmaps->getGlyph(current, size);
+    }
+  }
 }
 
 void TextFactory::setCharacterSize(size_t newCharacterSize) {
@@ -40,8 +62,77 @@ void TextFactory::setCharacterColor(sf::Color newCharacterColor) {
   characterColor = newCharacterColor;
 }
 
-sf::Text TextFactory::getText(const string &text) const {
-  sf::Text result(text, font, characterSize);
-  result.setFillColor(characterColor);
-  return result;
+size_t TextFactory::getCharacterSize() const {
+  return characterSize;
+}
+
+sf::Color TextFactory::getCharacterColor() const {
+  return characterColor;
+}
+
+const sf::Texture &TextFactory::getTexture() const {
+  return font.getTexture(unsigned(characterSize));
+}
+
+const GlyphBitmaps &TextFactory::getGlyphBitmaps() const {
+  if (!glyphBitmaps) {
+    throw runtime_error("No font is loaded");
+  }
+  return *glyphBitmaps;
+}
+
+void TextFactory::appendText(sf::VertexArray &vertices, const string &text, double x, double y) const {
+  if (text.empty()) {
+    return;
+  }
+
+  // Glyphs are laid out along the baseline like sf::Text does, then moved so that their bounds are centred
+  auto size = unsigned(characterSize);
+  float whitespaceWidth = font.getGlyph(' ', size, false).advance;
+  float penX = 0;
+  float minX = numeric_limits<float>::max(), minY = minX, maxX = numeric_limits<float>::lowest(), maxY = maxX;
+  auto firstVertex = vertices.getVertexCount();
+  sf::Uint32 previous = 0;
+  for (auto character:text) {
+    sf::Uint32 current = static_cast<unsigned char>(character);
+    penX += font.getKerning(previous, current, size);
+    previous = current;
+    if (current == ' ' || current == '\t') {
+      minX = min(minX, penX);
+      minY = min(minY, 0.f);
+      penX += current == ' ' ? whitespaceWidth : 4 * whitespaceWidth;
+      maxX = max(maxX, penX);
+      maxY = max(maxY, 0.f);
+      continue;
+    }
+
+    const auto &glyph = font.getGlyph(current, size, false);
+    const auto &bounds = glyph.bounds;
+    minX = min(minX, penX + bounds.left);
+    minY = min(minY, bounds.top);
+    maxX = max(maxX, penX + bounds.left + bounds.width);
+    maxY = max(maxY, bounds.top + bounds.height);
+
+    // A pixel of padding keeps smoothed edges of the glyph, as in sf::Text
+    const float padding = 1;
+    float left = penX + bounds.left - padding, top = bounds.top - padding;
+    float right = penX + bounds.left + bounds.width + padding, bottom = bounds.top + bounds.height + padding;
+    const auto &rect = glyph.textureRect;
+    float u1 = float(rect.left) - padding, v1 = float(rect.top) - padding;
+    float u2 = float(rect.left + rect.width) + padding, v2 = float(rect.top + rect.height) + padding;
+    sf::Vertex corners[] = {sf::Vertex(sf::Vector2f(left, top), characterColor, sf::Vector2f(u1, v1)),
+                            sf::Vertex(sf::Vector2f(right, top), characterColor, sf::Vector2f(u2, v1)),
+                            sf::Vertex(sf::Vector2f(right, bottom), characterColor, sf::Vector2f(u2, v2)),
+                            sf::Vertex(sf::Vector2f(left, bottom), characterColor, sf::Vector2f(u1, v2))};
+    for (auto corner:{0, 1, 2, 0, 2, 3}) {
+      vertices.append(corners[corner]);
+    }
+    penX += glyph.advance;
+  }
+
+  float offsetX = float(x) - (minX + maxX) / 2, offsetY = float(y) - (minY + maxY) / 2;
+  for (auto i = firstVertex; i < vertices.getVertexCount(); ++i) {
+    vertices[i].position.x += offsetX;
+    vertices[i].position.y += offsetY;
+  }
 }
@@ -3,27 +3,53 @@
 //
 #pragma once
 
+#include "GlyphBitmaps.h"
+#include "MappedFile.h"
+#include "RenderBackend.h"
 #include <SFML/Graphics.hpp>
+#include <memory>
 
 using std::string;
 using std::unique_ptr;
 
 class TextFactory {
-  unique_ptr<char[]> fontData;
+  // The font and the bitmaps read the mapped file in place, the pages are shared with other processes mapping it
+  unique_ptr<MappedFile> fontFile;
+  string fontPath;
   sf::Font font;
+  unique_ptr<GlyphBitmaps> glyphBitmaps;
   size_t characterSize = 10;
   sf::Color characterColor;
 
   TextFactory();
 
 public:
+  // Characters of the default names of nodes, their numbers
+  static const string nameCharacters;
+
   static TextFactory &getTextFactory();
 
+  // Loading the font already loaded keeps it, with the glyphs rasterized so far
   void loadFontFromFile(const string &path);
 
+  // Rasterizes the characters at the character size ahead of the first draw that needs them, into the glyph atlas
+  // for the GL backend or into the bitmaps for the software one. Nothing happens before a font is loaded.
+  void preloadGlyphs(const string &characters, RenderBackend backend) const;
+
   void setCharacterSize(size_t newCharacterSize);
 
   void setCharacterColor(sf::Color newCharacterColor);
 
-  sf::Text getText(const string &text) const;
+  [[nodiscard]] size_t getCharacterSize() const;
+
+  [[nodiscard]] sf::Color getCharacterColor() const;
+
+  // Glyph atlas of the character size, the texture of the quads made by appendText
+  [[nodiscard]] const sf::Texture &getTexture() const;
+
+  // Glyphs of the font for drawing without a GL context, throws before a font is loaded
+  [[nodiscard]] const GlyphBitmaps &getGlyphBitmaps() const;
+
+  // Appends glyph quads of the text centred at (x, y) as sf::Text would place them, two triangles a glyph
+  void appendText(sf::VertexArray &vertices, const string &text, double x, double y) const;
 };
\ No newline at end of file
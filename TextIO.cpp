@@ -0,0 +1,389 @@
+#include "TextIO.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using std::from_chars;
+using std::to_chars;
+using std::errc;
+using std::runtime_error;
+using std::to_string;
+using std::move;
+using std::max;
+
+TextReader::TextReader(istream &in) : in(in), buffer(blockSize) {}
+
+bool TextReader::isSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+bool TextReader::refill() {
+  if (isStreamOver) {
+    return false;
+  }
+  end -= position;
+  memmove(buffer.data(), buffer.data() + position, end);
+  position = 0;
+  if (buffer.size() < end + blockSize) {
+    buffer.resize(end + blockSize);
+  }
+
+  in.read(buffer.data() + end, std::streamsize(blockSize));
+  auto read = size_t(in.gcount());
+  end += read;
+  if (read < blockSize) {
+    isStreamOver = true;
+  }
+  return read > 0;
+}
+
+bool TextReader::skipWhitespace() {
+  while (true) {
+    while (position < end && isSpace(buffer[position])) {
+      ++position;
+    }
+    if (position < end) {
+      return true;
+    }
+    if (!refill()) {
+      return false;
+    }
+  }
+}
+
+template<typename Number>
+Number TextReader::readNumber() {
+  if (!skipWhitespace()) {
+    throw runtime_error("Unexpected end of text");
+  }
+  // The whole number has to be in the buffer
+  if (end - position < maxTokenLength) {
+    refill();
+  }
+
+  Number number{};
+  const char *first = buffer.data() + position, *last = buffer.data() + end;
+  auto result = from_chars(first, last, number);
+  if (result.ec != errc()) {
+    throw runtime_error("Malformed number in text: " + string(first, std::min(last, first + 16)));
+  }
+  position = size_t(result.ptr - buffer.data());
+  return number;
+}
+
+size_t TextReader::readSize() {
+  return readNumber<size_t>();
+}
+
+int TextReader::readInt() {
+  return readNumber<int>();
+}
+
+double TextReader::readDouble() {
+  return readNumber<double>();
+}
+
+int TextReader::get() {
+  if (position == end && !refill()) {
+    return -1;
+  }
+  return static_cast<unsigned char>(buffer[position++]);
+}
+
+int TextReader::peek() {
+  if (position == end && !refill()) {
+    return -1;
+  }
+  return static_cast<unsigned char>(buffer[position]);
+}
+
+string TextReader::readLine() {
+  string line;
+  while (true) {
+    const char *first = buffer.data() + position, *last = buffer.data() + end;
+    auto *lineEnd = static_cast<const char *>(memchr(first, '\n', size_t(last - first)));
+    if (lineEnd != nullptr) {
+      line.append(first, lineEnd);
+      position = size_t(lineEnd - buffer.data()) + 1;
+      return line;
+    }
+    line.append(first, last);
+    position = end;
+    if (!refill()) {
+      return line;
+    }
+  }
+}
+
+void TextReader::skipLine() {
+  while (true) {
+    const char *first = buffer.data() + position;
+    auto *lineEnd = static_cast<const char *>(memchr(first, '\n', end - position));
+    if (lineEnd != nullptr) {
+      position = size_t(lineEnd - buffer.data()) + 1;
+      return;
+    }
+    position = end;
+    if (!refill()) {
+      return;
+    }
+  }
+}
+
+TextWriter::TextWriter(ostream &out) : out(out), buffer(blockSize) {}
+
+TextWriter::~TextWriter() {
+  if (size > 0) {
+    out.write(buffer.data(), std::streamsize(size));
+  }
+}
+
+char *TextWriter::reserve(size_t length) {
+  if (size + length > buffer.size()) {
+    out.write(buffer.data(), std::streamsize(size));
+    written += size;
+    size = 0;
+    if (length > buffer.size()) {
+      buffer.resize(length);
+    }
+  }
+  auto *result = buffer.data() + size;
+  size += length;
+  return result;
+}
+
+void TextWriter::write(const char *data, size_t length) {
+  memcpy(reserve(length), data, length);
+}
+
+void TextWriter::write(const string &text) {
+  write(text.data(), text.size());
+}
+
+void TextWriter::put(char c) {
+  *reserve(1) = c;
+}
+
+void TextWriter::writeSize(size_t value) {
+  char digits[24];
+  auto result = to_chars(digits, digits + sizeof digits, value);
+  write(digits, size_t(result.ptr - digits));
+}
+
+void TextWriter::writeDouble(double value) {
+  char digits[32];
+  auto result = to_chars(digits, digits + sizeof digits, value);
+  write(digits, size_t(result.ptr - digits));
+}
+
+void TextWriter::writeFixed(double value, int decimals) {
+  char digits[48];
+  auto result = to_chars(digits, digits + sizeof digits, value, std::chars_format::fixed, decimals);
+  if (result.ec != errc()) {
+    throw runtime_error("Unable to write " + to_string(value));
+  }
+  auto *end = result.ptr;
+  if (decimals > 0) {
+    while (end[-1] == '0') {
+      --end;
+    }
+    if (end[-1] == '.') {
+      --end;
+    }
+  }
+  // Rounding may leave a negative zero
+  if (end - digits == 2 && digits[0] == '-' && digits[1] == '0') {
+    put('0');
+    return;
+  }
+  write(digits, size_t(end - digits));
+}
+
+size_t TextWriter::getPosition() const {
+  return written + size;
+}
+
+void TextWriter::flush() {
+  out.write(buffer.data(), std::streamsize(size));
+  written += size;
+  size = 0;
+  out.flush();
+  if (!out) {
+    throw runtime_error("IO error while writing text");
+  }
+}
+
+MatrixText readMatrixText(istream &in, JobProgress *progress) {
+  TextReader reader(in);
+  MatrixText matrix;
+  auto n = matrix.numberOfNodes = reader.readSize();
+  for (size_t i = 0; i < n; ++i) {
+    if (progress != nullptr) {
+      progress->report(double(i) / double(n));
+    }
+    // Only the lower triangle is used, the matrix is symmetric
+    reader.readInts(n, [&matrix, i](size_t j, int value) {
+      if (j < i && value != 0) {
+        matrix.links.emplace_back(i, j);
+      }
+    });
+  }
+  return matrix;
+}
+
+void writeMatrixText(ostream &out, const GraphCore &core) {
+  auto n = core.getNumberOfNodes();
+
+  // Neighbours of every node, rows are stamped over a row of zeros
+  vector<size_t> offsets(n + 1);
+  for (const auto &[first, second]:core.getLinks()) {
+    ++offsets[first + 1];
+    ++offsets[second + 1];
+  }
+  for (size_t i = 0; i < n; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  vector<GraphCore::NodeId> neighbours(offsets[n]);
+  {
+    vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+    for (const auto &[first, second]:core.getLinks()) {
+      neighbours[positions[first]++] = second;
+      neighbours[positions[second]++] = first;
+    }
+  }
+
+  string zeros;
+  for (size_t j = 0; j < n; ++j) {
+    zeros += "0 ";
+  }
+  zeros += '\n';
+
+  TextWriter writer(out);
+  writer.writeSize(n);
+  writer.put('\n');
+  for (size_t i = 0; i < n; ++i) {
+    auto *row = writer.reserve(zeros.size());
+    memcpy(row, zeros.data(), zeros.size());
+    for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+      row[2 * neighbours[k]] = '1';
+    }
+  }
+  writer.flush();
+}
+
+// n lines "x y name" of the nodes format
+void readNodeLines(TextReader &reader, GraphCore &core, size_t n) {
+  core.reserveNodes(core.getNumberOfNodes() + n);
+  for (size_t i = 0; i < n; ++i) {
+    double x = reader.readDouble();
+    double y = reader.readDouble();
+    auto node = core.addNode(x, y);
+    // A name is separated from the coordinates by one character, a line break right after them means no name
+    auto separator = reader.get();
+    if (separator != '\n' && separator != -1) {
+      core.setName(node, reader.readLine());
+    }
+  }
+}
+
+void writeNodeLines(TextWriter &writer, const GraphCore &core) {
+  for (GraphCore::NodeId i = 0; i < core.getNumberOfNodes(); ++i) {
+    writer.writeDouble(core.getX(i));
+    writer.put(' ');
+    writer.writeDouble(core.getY(i));
+    writer.put(' ');
+    writer.write(core.getName(i));
+    writer.put('\n');
+  }
+}
+
+void readNodesText(istream &in, GraphCore &core) {
+  TextReader reader(in);
+  readNodeLines(reader, core, reader.readSize());
+}
+
+void writeNodesText(ostream &out, const GraphCore &core) {
+  TextWriter writer(out);
+  writer.writeSize(core.getNumberOfNodes());
+  writer.put('\n');
+  writeNodeLines(writer, core);
+  writer.flush();
+}
+
+// False at the end of the stream
+bool skipComments(TextReader &reader) {
+  while (reader.skipWhitespace()) {
+    if (reader.peek() != '#') {
+      return true;
+    }
+    reader.skipLine();
+  }
+  return false;
+}
+
+void readEdgeListText(istream &in, GraphCore &core, double latticeStep, JobProgress *progress) {
+  static const string headerKeyword = "nodes";
+
+  TextReader reader(in);
+  auto firstNode = core.getNumberOfNodes();
+  bool hasHeader = false;
+  if (skipComments(reader) && reader.peek() == headerKeyword[0]) {
+    for (auto c:headerKeyword) {
+      if (reader.get() != c) {
+        throw runtime_error("Malformed header of edge list");
+      }
+    }
+    readNodeLines(reader, core, reader.readSize());
+    hasHeader = true;
+  }
+
+  // The length of the stream is unknown, so only cancellation is checked
+  for (size_t line = 0; skipComments(reader); ++line) {
+    if (progress != nullptr && line % 65536 == 0) {
+      progress->check();
+    }
+    auto first = reader.readSize(), second = reader.readSize();
+    reader.skipLine();
+    auto largest = max(first, second);
+    if (hasHeader && largest >= core.getNumberOfNodes() - firstNode) {
+      throw runtime_error("Link " + to_string(first) + " " + to_string(second) + " of edge list has no node");
+    }
+    if (!hasHeader && largest >= maxEdgeListNodes) {
+      throw runtime_error("Node id " + to_string(largest) + " of edge list without a header is above the limit of " +
+                          to_string(maxEdgeListNodes - 1));
+    }
+    while (core.getNumberOfNodes() - firstNode <= largest) {
+      core.addNode(0, 0);
+    }
+    if (first != second) {
+      core.addLink(GraphCore::NodeId(firstNode + first), GraphCore::NodeId(firstNode + second));
+    }
+  }
+
+  if (!hasHeader) {
+    auto n = core.getNumberOfNodes() - firstNode;
+    auto side = size_t(ceil(sqrt(double(n))));
+    for (size_t i = 0; i < n; ++i) {
+      core.setX(GraphCore::NodeId(firstNode + i), double(i % side + 1) * latticeStep);
+      core.setY(GraphCore::NodeId(firstNode + i), double(i / side + 1) * latticeStep);
+    }
+  }
+  core.removeRepeatedLinks();
+}
+
+void writeEdgeListText(ostream &out, const GraphCore &core) {
+  TextWriter writer(out);
+  writer.write("nodes ");
+  writer.writeSize(core.getNumberOfNodes());
+  writer.put('\n');
+  writeNodeLines(writer, core);
+  for (const auto &[first, second]:core.getLinks()) {
+    writer.writeSize(first);
+    writer.put(' ');
+    writer.writeSize(second);
+    writer.put('\n');
+  }
+  writer.flush();
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "GraphCore.h"
+#include "JobProgress.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+
+using std::istream;
+using std::ostream;
+using std::vector;
+using std::string;
+using std::pair;
+
+// Reads a stream in large blocks and parses numbers with from_chars, independent of the locale. Reads ahead of
+// what it parsed, so the stream should not be read by anything else afterwards.
+class TextReader {
+  static constexpr size_t blockSize = size_t(1) << 20u;
+  // Longer numbers are malformed
+  static constexpr size_t maxTokenLength = 128;
+
+  istream &in;
+  vector<char> buffer;
+  size_t position = 0, end = 0;
+  bool isStreamOver = false;
+
+  // Keeps the unread characters and appends the next block, false when nothing was added
+  bool refill();
+
+  [[nodiscard]] static bool isSpace(char c);
+
+  template<typename Number>
+  Number readNumber();
+
+public:
+  explicit TextReader(istream &in);
+
+  // False at the end of the stream
+  bool skipWhitespace();
+
+  // Skips whitespace before the number
+  size_t readSize();
+
+  int readInt();
+
+  double readDouble();
+
+  // Next character or -1 at the end of the stream
+  int get();
+
+  // Next character left unread, -1 at the end of the stream
+  int peek();
+
+  // Rest of the line without the line break
+  string readLine();
+
+  // Skips the rest of the line with the line break
+  void skipLine();
+
+  // Calls function(k, value) for count integers in a row, single digits are parsed without from_chars
+  template<typename Function>
+  void readInts(size_t count, Function function);
+};
+
+template<typename Function>
+void TextReader::readInts(size_t count, Function function) {
+  for (size_t k = 0; k < count; ++k) {
+    if (end - position < maxTokenLength && !isStreamOver) {
+      refill();
+    }
+    while (position < end && isSpace(buffer[position])) {
+      ++position;
+    }
+    if (position + 1 < end && buffer[position] >= '0' && buffer[position] <= '9' && isSpace(buffer[position + 1])) {
+      function(k, buffer[position] - '0');
+      position += 2;
+    } else {
+      function(k, readInt());
+    }
+  }
+}
+
+// Writes into a large buffer handed to the stream at once, formats numbers with to_chars
+class TextWriter {
+  static constexpr size_t blockSize = size_t(1) << 20u;
+
+  ostream &out;
+  vector<char> buffer;
+  size_t size = 0;
+  // Bytes handed to the stream
+  size_t written = 0;
+
+public:
+  explicit TextWriter(ostream &out);
+
+  TextWriter(const TextWriter &) = delete;
+
+  TextWriter &operator=(const TextWriter &) = delete;
+
+  ~TextWriter();
+
+  // Space for length characters at the end of the text, valid until the next call
+  char *reserve(size_t length);
+
+  void write(const char *data, size_t length);
+
+  void write(const string &text);
+
+  void put(char c);
+
+  void writeSize(size_t value);
+
+  // Shortest representation that reads back to the same double
+  void writeDouble(double value);
+
+  // Rounded to the decimals, without trailing zeros
+  void writeFixed(double value, int decimals);
+
+  // Bytes written so far, including the buffered ones
+  [[nodiscard]] size_t getPosition() const;
+
+  // Throws if the stream failed
+  void flush();
+};
+
+// Text matrix: its dimension, then n rows of n integers separated by whitespace, non-zero ones above the diagonal
+// meaning links. Links are read as (i, j) with j < i in the order of rows.
+struct MatrixText {
+  size_t numberOfNodes = 0;
+  vector<pair<size_t, size_t>> links;
+};
+
+// Reports the share of rows read
+MatrixText readMatrixText(istream &in, JobProgress *progress = nullptr);
+
+void writeMatrixText(ostream &out, const GraphCore &core);
+
+// Text nodes: their number, then a line "x y name" per node, the name taking the rest of the line. Links of the
+// core are left as they are.
+void readNodesText(istream &in, GraphCore &core);
+
+void writeNodesText(ostream &out, const GraphCore &core);
+
+// Most nodes an edge list without a header may make from its largest id
+constexpr size_t maxEdgeListNodes = size_t(1) << 24u;
+
+// Edge list: a line "u v" of node ids per link, the rest of a link line and lines starting with '#' are ignored.
+// It may start with a header "nodes n" followed by n lines of nodes as in the nodes format, otherwise there are
+// as many nodes as the largest id plus one, at most maxEdgeListNodes, named by their ids and placed on a square
+// lattice of the step one step away from the axes.
+// Links are added to the core as they are read, with nothing kept per link but the link, loops are dropped then
+// and repeated links once all are read by GraphCore::removeRepeatedLinks, which freezes the core.
+void readEdgeListText(istream &in, GraphCore &core, double latticeStep, JobProgress *progress = nullptr);
+
+// With the header, links in the order of the core
+void writeEdgeListText(ostream &out, const GraphCore &core);
@@ -0,0 +1,181 @@
+#include "TiledImageExport.h"
+#include "PngStreamWriter.h"
+#include "Link.h"
+#include "TextFactory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using std::atomic;
+using std::thread;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
+using std::runtime_error;
+using std::min;
+using std::max;
+
+// Pixels of the image per unit of the plane, and the point of the plane at its top left corner
+struct ImagePlacement {
+  double scale, left, top;
+};
+
+ImagePlacement placeArea(const sf::Rect<double> &area, unsigned width, unsigned height) {
+  double scale = min(width / max(area.width, 1e-9), height / max(area.height, 1e-9));
+  return {scale, area.left + (area.width - width / scale) / 2, area.top + (area.height - height / scale) / 2};
+}
+
+// View of the pixels from (x, y) on, width by height of them
+sf::View getTileView(const ImagePlacement &placement, unsigned x, unsigned y, unsigned width, unsigned height) {
+  return sf::View(sf::FloatRect(float(placement.left + x / placement.scale), float(placement.top + y / placement.scale),
+                                float(width / placement.scale), float(height / placement.scale)));
+}
+
+// Copies rows of columns pixels from a tile with stride pixels a row into the band at column x
+void copyTile(const uint8_t *tile, unsigned stride, unsigned columns, unsigned rows, vector<uint8_t> &band,
+              unsigned width, unsigned x) {
+  for (unsigned row = 0; row < rows; ++row) {
+    std::memcpy(band.data() + (size_t(row) * width + x) * 4, tile + size_t(row) * stride * 4, size_t(columns) * 4);
+  }
+}
+
+// Draws the image band by band, drawBand(top, rows, band) filling rows of the band from row top of the image
+void writeBands(ostream &out, unsigned width, unsigned height, unsigned tileSize,
+                const function<void(unsigned, unsigned, vector<uint8_t> &)> &drawBand) {
+  if (tileSize == 0) {
+    throw runtime_error("Tiles need at least one pixel");
+  }
+  PngStreamWriter png(out, width, height);
+  vector<uint8_t> band(size_t(width) * min(tileSize, height) * 4);
+  for (unsigned top = 0; top < height; top += tileSize) {
+    auto rows = min(tileSize, height - top);
+    drawBand(top, rows, band);
+    for (unsigned row = 0; row < rows; ++row) {
+      png.writeRow(band.data() + size_t(row) * width * 4);
+    }
+  }
+  png.finish();
+}
+
+// Listed indices, or all below count for nullptr, that pass the test
+template<typename Test>
+void selectIndices(vector<size_t> &selected, const vector<size_t> *listed, size_t count, Test test) {
+  selected.clear();
+  if (listed != nullptr) {
+    for (auto index:*listed) {
+      if (test(index)) {
+        selected.push_back(index);
+      }
+    }
+  } else {
+    for (size_t index = 0; index < count; ++index) {
+      if (test(index)) {
+        selected.push_back(index);
+      }
+    }
+  }
+}
+
+void writeTiledPng(ostream &out, const GraphCore &core, const vector<size_t> *nodes, const vector<size_t> *links,
+                   const sf::Rect<double> &area, const TiledImageSettings &settings) {
+  auto placement = placeArea(area, settings.width, settings.height);
+  auto tileSize = settings.tileSize;
+  auto numberOfThreads = settings.numberOfThreads;
+  if (numberOfThreads == 0) {
+    numberOfThreads = max(1u, thread::hardware_concurrency());
+  }
+
+  // How far a disc and a label centred at a node, or the end of a link, reach past the centre, a pixel to spare
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto characterSize = double(TextFactory::getTextFactory().getCharacterSize());
+  double pixel = 1 / placement.scale, linkReach = Link::width / 2 + pixel;
+  auto getNodeReach = [&](size_t node) {
+    return max(nodeSettings.radius, double(core.getName(GraphCore::NodeId(node)).size() + 1) * characterSize / 2) +
+           pixel;
+  };
+
+  vector<size_t> bandNodes, bandLinks;
+  writeBands(out, settings.width, settings.height, tileSize, [&](unsigned top, unsigned rows, vector<uint8_t> &band) {
+    double bandTop = placement.top + top * pixel, bandBottom = bandTop + rows * pixel;
+    selectIndices(bandNodes, nodes, core.getNumberOfNodes(), [&](size_t node) {
+      auto y = core.getY(GraphCore::NodeId(node));
+      auto reach = getNodeReach(node);
+      return y + reach >= bandTop && y - reach <= bandBottom;
+    });
+    selectIndices(bandLinks, links, core.getNumberOfLinks(), [&](size_t link) {
+      auto[first, second] = core.getLink(link);
+      auto y1 = core.getY(first), y2 = core.getY(second);
+      return max(y1, y2) + linkReach >= bandTop && min(y1, y2) - linkReach <= bandBottom;
+    });
+
+    // Tiles of the band share no pixels, so threads copy them into it without locks
+    size_t columns = (settings.width + tileSize - 1) / tileSize;
+    auto numberOfWorkers = min(numberOfThreads, columns);
+    atomic<size_t> nextColumn(0);
+    atomic<bool> failed(false);
+    exception_ptr failure;
+    auto work = [&]() {
+      try {
+        SoftwareRasterizer rasterizer(tileSize, rows);
+        vector<size_t> tileNodes, tileLinks;
+        for (size_t column = nextColumn++; column < columns && !failed; column = nextColumn++) {
+          auto x = unsigned(column * tileSize);
+          double tileLeft = placement.left + x * pixel, tileRight = tileLeft + tileSize * pixel;
+          selectIndices(tileNodes, &bandNodes, 0, [&](size_t node) {
+            auto nodeX = core.getX(GraphCore::NodeId(node));
+            auto reach = getNodeReach(node);
+            return nodeX + reach >= tileLeft && nodeX - reach <= tileRight;
+          });
+          selectIndices(tileLinks, &bandLinks, 0, [&](size_t link) {
+            auto[first, second] = core.getLink(link);
+            auto x1 = core.getX(first), x2 = core.getX(second);
+            return max(x1, x2) + linkReach >= tileLeft && min(x1, x2) - linkReach <= tileRight;
+          });
+
+          rasterizer.setView(getTileView(placement, x, top, tileSize, rows));
+          rasterizer.clear(sf::Color::White);
+          // Threads left over from a narrow image split the rows of its tiles
+          rasterizer.draw(core, tileNodes, tileLinks, numberOfThreads / numberOfWorkers);
+          copyTile(rasterizer.getPixels(), tileSize, min(tileSize, settings.width - x), rows, band, settings.width, x);
+        }
+      } catch (...) {
+        if (!failed.exchange(true)) {
+          failure = current_exception();
+        }
+      }
+    };
+
+    vector<thread> workers;
+    for (size_t i = 0; i < numberOfWorkers; ++i) {
+      workers.emplace_back(work);
+    }
+    for (auto &worker:workers) {
+      worker.join();
+    }
+    if (failure) {
+      rethrow_exception(failure);
+    }
+  });
+}
+
+void writeTiledPng(ostream &out, const function<void(sf::RenderTarget &)> &draw, const sf::Rect<double> &area,
+                   const TiledImageSettings &settings) {
+  auto placement = placeArea(area, settings.width, settings.height);
+  auto tileSize = min(settings.tileSize, sf::Texture::getMaximumSize());
+  sf::RenderTexture texture;
+  if (tileSize == 0 || !texture.create(tileSize, tileSize)) {
+    throw runtime_error("Unable to create a render texture for tiles of " + std::to_string(tileSize) + " pixels");
+  }
+
+  writeBands(out, settings.width, settings.height, tileSize, [&](unsigned top, unsigned rows, vector<uint8_t> &band) {
+    for (unsigned x = 0; x < settings.width; x += tileSize) {
+      texture.setView(getTileView(placement, x, top, tileSize, tileSize));
+      texture.clear(sf::Color::White);
+      draw(texture);
+      texture.display();
+      auto image = texture.getTexture().copyToImage();
+      copyTile(image.getPixelsPtr(), tileSize, min(tileSize, settings.width - x), rows, band, settings.width, x);
+    }
+  });
+}
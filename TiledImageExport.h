@@ -0,0 +1,31 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+#include <functional>
+#include <iostream>
+
+using std::ostream;
+using std::function;
+
+struct TiledImageSettings {
+  unsigned width = 600, height = 600;
+  // Side of the square tiles, a band of tiles across the image is held at once
+  unsigned tileSize = 1024;
+  // Threads drawing the tiles of a band on the CPU, zero for one per hardware thread
+  size_t numberOfThreads = 0;
+};
+
+// Both write a PNG of the area of the plane, scaled to fit the image and centred in it, on a white background. The
+// image is drawn in bands of tiles, each tile through a view offset to its part of the area, and the rows of a band
+// are deflated into the file before the next band is drawn, so memory stays near width * tileSize pixels whatever
+// the size of the image.
+
+// Tiles of a band are drawn by SoftwareRasterizer on threads of their own, each with the nodes and links that reach
+// into it. Nodes and links are the listed ones, or all of them for nullptr.
+void writeTiledPng(ostream &out, const GraphCore &core, const vector<size_t> *nodes, const vector<size_t> *links,
+                   const sf::Rect<double> &area, const TiledImageSettings &settings);
+
+// Tiles are drawn one by one by draw into a single render texture, so the calling thread needs a GL context. The
+// tile size is capped by the largest texture.
+void writeTiledPng(ostream &out, const function<void(sf::RenderTarget &)> &draw, const sf::Rect<double> &area,
+                   const TiledImageSettings &settings);
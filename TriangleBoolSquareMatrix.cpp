@@ -5,21 +5,80 @@
 #pragma ide diagnostic ignored "UnusedGlobalDeclarationInspection"
 
 #include "TriangleBoolSquareMatrix.h"
+#include "CompressedAdjacency.h"
 #include <random>
+#include <algorithm>
 
-using std::endl;
 using std::out_of_range;
 using std::runtime_error;
 using std::to_string;
 using std::random_device;
-using std::mt19937;
-using std::bernoulli_distribution;
+using std::mt19937_64;
+
+size_t countBits(uint64_t word) {
+#if defined(__GNUC__)
+  return size_t(__builtin_popcountll(word));
+#else
+  word -= (word >> 1u) & 0x5555555555555555ull;
+  word = (word & 0x3333333333333333ull) + ((word >> 2u) & 0x3333333333333333ull);
+  word = (word + (word >> 4u)) & 0x0f0f0f0f0f0f0f0full;
+  return size_t((word * 0x0101010101010101ull) >> 56u);
+#endif
+}
+
+size_t TriangleBoolSquareMatrix::getLowestBit(uint64_t word) {
+#if defined(__GNUC__)
+  return size_t(__builtin_ctzll(word));
+#else
+  size_t bit = 0;
+  while ((word & 1u) == 0) {
+    word >>= 1u;
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+TriangleBoolSquareMatrix::Reference::Reference(uint64_t *word, uint64_t mask) : word(word), mask(mask) {}
+
+TriangleBoolSquareMatrix::Reference &TriangleBoolSquareMatrix::Reference::operator=(bool value) {
+  if (value) {
+    *word |= mask;
+  } else {
+    *word &= ~mask;
+  }
+  return *this;
+}
+
+TriangleBoolSquareMatrix::Reference &TriangleBoolSquareMatrix::Reference::operator=(const Reference &other) {
+  return *this = bool(int(other));
+}
+
+TriangleBoolSquareMatrix::Reference::operator int() const {
+  return (*word & mask) != 0;
+}
+
+TriangleBoolSquareMatrix::TriangleBoolSquareMatrix(size_t n) : n(n) {
+  resizeRows();
+}
 
-TriangleBoolSquareMatrix::TriangleBoolSquareMatrix(size_t n) : n(n), data(n * (n - 1) / 2) {}
+void TriangleBoolSquareMatrix::resizeRows() {
+  // Offsets of the first rows do not depend on n, so growing keeps the elements already set
+  rowOffsets.resize(n + 1);
+  rowOffsets[0] = 0;
+  for (size_t i = 0; i < n; ++i) {
+    rowOffsets[i + 1] = rowOffsets[i] + getWordCount(i);
+  }
+  data.resize(rowOffsets[n]);
+}
+
+size_t TriangleBoolSquareMatrix::getWordCount(size_t numberOfElements) {
+  return (numberOfElements + wordBits - 1) / wordBits;
+}
 
 int TriangleBoolSquareMatrix::at(size_t i, size_t j) const {
   if (i > 0 && i < n && j < i) {
-    return data[i * (i - 1) / 2 + j];
+    return unsafeAt(i, j);
   } else {
     throw out_of_range(to_string(i) + ", " + to_string(j) + " is out of range of triangle square matrix of " +
                        to_string(n) + " dimension");
@@ -27,20 +86,81 @@ int TriangleBoolSquareMatrix::at(size_t i, size_t j) const {
 }
 
 int TriangleBoolSquareMatrix::unsafeAt(size_t i, size_t j) const {
-  return data[i * (i - 1) / 2 + j];
+  return int(data[rowOffsets[i] + j / wordBits] >> (j % wordBits) & 1u);
 }
 
-int &TriangleBoolSquareMatrix::at(size_t i, size_t j) {
+TriangleBoolSquareMatrix::Reference TriangleBoolSquareMatrix::at(size_t i, size_t j) {
   if (i > 0 && i < n && j < i) {
-    return data[i * (i - 1) / 2 + j];
+    return unsafeAt(i, j);
   } else {
     throw out_of_range(to_string(i) + ", " + to_string(j) + " is out of range of triangle square matrix of " +
                        to_string(n) + " dimension");
   }
 }
 
-int &TriangleBoolSquareMatrix::unsafeAt(size_t i, size_t j) {
-  return data[i * (i - 1) / 2 + j];
+TriangleBoolSquareMatrix::Reference TriangleBoolSquareMatrix::unsafeAt(size_t i, size_t j) {
+  return {&data[rowOffsets[i] + j / wordBits], uint64_t(1) << (j % wordBits)};
+}
+
+const uint64_t *TriangleBoolSquareMatrix::getRowWords(size_t i) const {
+  return data.data() + rowOffsets[i];
+}
+
+vector<uint64_t> TriangleBoolSquareMatrix::getNeighbourSet(size_t i) const {
+  vector<uint64_t> neighbours(getWordCount(n));
+  copy(getRowWords(i), getRowWords(i) + getWordCount(i), neighbours.begin());
+  for (size_t j = i + 1; j < n; ++j) {
+    neighbours[j / wordBits] |= uint64_t(unsafeAt(j, i)) << (j % wordBits);
+  }
+  return neighbours;
+}
+
+size_t TriangleBoolSquareMatrix::getDegree(size_t i) const {
+  auto neighbours = getNeighbourSet(i);
+  return countWords(neighbours.data(), neighbours.size());
+}
+
+size_t TriangleBoolSquareMatrix::countCommonNeighbours(size_t i, size_t j) const {
+  auto firstNeighbours = getNeighbourSet(i), secondNeighbours = getNeighbourSet(j);
+  return countAndWords(firstNeighbours.data(), secondNeighbours.data(), firstNeighbours.size());
+}
+
+size_t TriangleBoolSquareMatrix::countCommonInRows(size_t i, size_t j) const {
+  // Bits past the end of the shorter row are not set in its last word
+  return countAndWords(getRowWords(i), getRowWords(j), getWordCount(std::min(i, j)));
+}
+
+void TriangleBoolSquareMatrix::andWords(vector<uint64_t> &target, const vector<uint64_t> &source) {
+  auto wordCount = std::min(target.size(), source.size());
+  for (size_t k = 0; k < wordCount; ++k) {
+    target[k] &= source[k];
+  }
+  fill(target.begin() + long(wordCount), target.end(), 0);
+}
+
+void TriangleBoolSquareMatrix::orWords(vector<uint64_t> &target, const vector<uint64_t> &source) {
+  if (target.size() < source.size()) {
+    target.resize(source.size());
+  }
+  for (size_t k = 0; k < source.size(); ++k) {
+    target[k] |= source[k];
+  }
+}
+
+size_t TriangleBoolSquareMatrix::countWords(const uint64_t *words, size_t wordCount) {
+  size_t result = 0;
+  for (size_t k = 0; k < wordCount; ++k) {
+    result += countBits(words[k]);
+  }
+  return result;
+}
+
+size_t TriangleBoolSquareMatrix::countAndWords(const uint64_t *first, const uint64_t *second, size_t wordCount) {
+  size_t result = 0;
+  for (size_t k = 0; k < wordCount; ++k) {
+    result += countBits(first[k] & second[k]);
+  }
+  return result;
 }
 
 ostream &operator<<(ostream &out, const TriangleBoolSquareMatrix &matrix) {
@@ -52,7 +172,7 @@ ostream &TriangleBoolSquareMatrix::printTriangle(ostream &out) const {
     for (size_t j = 0; j < i; ++j) {
       out << at(i, j) << " ";
     }
-    out << endl;
+    out << '\n';
   }
   return out;
 }
@@ -68,7 +188,7 @@ ostream &TriangleBoolSquareMatrix::printFull(ostream &out) const {
         out << at(i, j) << " ";
       }
     }
-    out << endl;
+    out << '\n';
   }
 
   return out;
@@ -85,7 +205,7 @@ ostream &TriangleBoolSquareMatrix::printFullSubmatrix(ostream &out, const vector
         out << at(indexes[i], indexes[j]) << " ";
       }
     }
-    out << endl;
+    out << '\n';
   }
 
   return out;
@@ -96,7 +216,7 @@ ostream &TriangleBoolSquareMatrix::printTriangleSubmatrix(ostream &out, const ve
     for (size_t j = 0; j < i; ++j) {
       out << at(indexes[i], indexes[j]) << " ";
     }
-    out << endl;
+    out << '\n';
   }
 
   return out;
@@ -130,7 +250,7 @@ void TriangleBoolSquareMatrix::readFromStream(istream &in) {
     throw runtime_error("IO error while reading matrix from stream");
   }
 
-  data.resize(n * (n - 1) / 2);
+  resizeRows();
 
   auto c = static_cast<unsigned char>(in.get());
   size_t num = 0;
@@ -151,12 +271,54 @@ void TriangleBoolSquareMatrix::readFromStream(istream &in) {
   }
 }
 
+void TriangleBoolSquareMatrix::writeToStreamCompressed(ostream &out) const {
+  auto bytes = encodeAdjacency(*this);
+  uint64_t size = bytes.size();
+  out.write(reinterpret_cast<const char *>(&n), sizeof n);
+  out.write(reinterpret_cast<const char *>(&size), sizeof size);
+  out.write(reinterpret_cast<const char *>(bytes.data()), std::streamsize(size));
+}
+
+void TriangleBoolSquareMatrix::readFromStreamCompressed(istream &in) {
+  size_t newN;
+  uint64_t size;
+  in.read(reinterpret_cast<char *>(&newN), sizeof newN);
+  in.read(reinterpret_cast<char *>(&size), sizeof size);
+  if (!in) {
+    throw runtime_error("IO error while reading matrix from stream");
+  }
+
+  // Read in blocks, so that a corrupted size fails at the end of the stream rather than allocating it at once
+  vector<uint8_t> bytes;
+  const uint64_t blockSize = uint64_t(1) << 20u;
+  while (bytes.size() < size) {
+    auto oldSize = bytes.size();
+    auto length = std::min(blockSize, size - oldSize);
+    bytes.resize(oldSize + length);
+    in.read(reinterpret_cast<char *>(bytes.data() + oldSize), std::streamsize(length));
+    if (!in) {
+      throw runtime_error("IO error while reading matrix from stream");
+    }
+  }
+
+  // Every row takes a byte at least
+  if (newN > size) {
+    throw runtime_error("Compressed matrix of " + to_string(newN) + " rows is only " + to_string(size) + " bytes");
+  }
+  data.clear();
+  setDimension(newN);
+  decodeAdjacency(bytes.data(), bytes.size(), n, [this](size_t i, size_t j) {
+    unsafeAt(i, j) = true;
+  });
+}
+
 bool TriangleBoolSquareMatrix::operator==(const TriangleBoolSquareMatrix &second) const {
+  // Unused bits of the last word of every row are never set, so whole words can be compared
   return n == second.n && data == second.data;
 }
 
 void TriangleBoolSquareMatrix::writeToStreamTriangle(ostream &out) const {
-  out << n << endl;
+  out << n << '\n';
   printTriangle(out);
 }
 
@@ -164,7 +326,7 @@ void TriangleBoolSquareMatrix::readFromStreamTriangle(istream &in) {
   in >> n;
 
   int read;
-  data.resize(n * (n - 1) / 2);
+  resizeRows();
   for (size_t i = 1; i < n; ++i) {
     for (size_t j = 0; j < i; ++j) {
       in >> read;
@@ -174,7 +336,7 @@ void TriangleBoolSquareMatrix::readFromStreamTriangle(istream &in) {
 }
 
 void TriangleBoolSquareMatrix::writeToStreamFull(ostream &out) const {
-  out << n << endl;
+  out << n << '\n';
   printFull(out);
 }
 
@@ -182,7 +344,7 @@ void TriangleBoolSquareMatrix::readFromStreamFull(istream &in) {
   in >> n;
 
   int read;
-  data.resize(n * (n - 1) / 2);
+  resizeRows();
   for (size_t i = 0; i < n; ++i) {
     for (size_t j = 0; j < n; ++j) {
       in >> read;
@@ -198,19 +360,24 @@ size_t TriangleBoolSquareMatrix::getDimension() const {
 }
 
 void TriangleBoolSquareMatrix::randomInit() {
-  static mt19937 twisterEngine((random_device()()));
-  static bernoulli_distribution distribution;
+  static mt19937_64 twisterEngine((random_device()()));
 
+  // Every bit of a random word is set with probability 1/2, bits past the end of a row are cleared
   for (size_t i = 1; i < n; ++i) {
-    for (size_t j = 0; j < i; ++j) {
-      at(i, j) = distribution(twisterEngine);
+    auto *row = data.data() + rowOffsets[i];
+    auto wordCount = getWordCount(i);
+    for (size_t k = 0; k < wordCount; ++k) {
+      row[k] = twisterEngine();
+    }
+    if (i % wordBits != 0) {
+      row[wordCount - 1] &= (uint64_t(1) << (i % wordBits)) - 1;
     }
   }
 }
 
 void TriangleBoolSquareMatrix::setDimension(size_t newN) {
   n = newN;
-  data.resize(n * (n - 1) / 2);
+  resizeRows();
 }
 
 #pragma clang diagnostic pop
\ No newline at end of file
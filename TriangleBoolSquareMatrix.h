@@ -8,15 +8,40 @@
 
 #include <vector>
 #include <iostream>
+#include <cstdint>
 
 using std::vector;
 using std::ostream;
 using std::istream;
 
+// Lower triangle of a symmetric boolean matrix without the diagonal, one bit per element. Every row starts at
+// a 64-bit word, so rows and neighbour sets can be combined a word at a time.
 class TriangleBoolSquareMatrix {
   size_t n = 0;
-  vector<int> data;
+  vector<uint64_t> data;
+  // Row i takes words [rowOffsets[i], rowOffsets[i + 1])
+  vector<size_t> rowOffsets;
+
+  static constexpr size_t wordBits = 64;
+
+  void resizeRows();
+
 public:
+  // Bit of one element, assigning it changes the element
+  class Reference {
+    uint64_t *word;
+    uint64_t mask;
+
+  public:
+    Reference(uint64_t *word, uint64_t mask);
+
+    Reference &operator=(bool value);
+
+    Reference &operator=(const Reference &other);
+
+    operator int() const;
+  };
+
   TriangleBoolSquareMatrix() = default;
 
   explicit TriangleBoolSquareMatrix(size_t n);
@@ -31,9 +56,37 @@ public:
 
   [[nodiscard]] int unsafeAt(size_t i, size_t j) const;
 
-  int &at(size_t i, size_t j);
+  Reference at(size_t i, size_t j);
+
+  Reference unsafeAt(size_t i, size_t j);
+
+  // Number of words in bitsets of n elements
+  [[nodiscard]] static size_t getWordCount(size_t numberOfElements);
+
+  // Words of the elements (i, j) for j < i
+  [[nodiscard]] const uint64_t *getRowWords(size_t i) const;
 
-  int &unsafeAt(size_t i, size_t j);
+  // Bitset of all j adjacent to i, from row i for j < i and from column i for j > i
+  [[nodiscard]] vector<uint64_t> getNeighbourSet(size_t i) const;
+
+  [[nodiscard]] size_t getDegree(size_t i) const;
+
+  [[nodiscard]] size_t countCommonNeighbours(size_t i, size_t j) const;
+
+  // Number of k < min(i, j) set in both rows
+  [[nodiscard]] size_t countCommonInRows(size_t i, size_t j) const;
+
+  // Bitset operations over whole words, written as plain loops for the compiler to vectorize
+  static void andWords(vector<uint64_t> &target, const vector<uint64_t> &source);
+
+  static void orWords(vector<uint64_t> &target, const vector<uint64_t> &source);
+
+  [[nodiscard]] static size_t countWords(const uint64_t *words, size_t wordCount);
+
+  [[nodiscard]] static size_t countAndWords(const uint64_t *first, const uint64_t *second, size_t wordCount);
+
+  // Index of the lowest set bit of a non-zero word
+  [[nodiscard]] static size_t getLowestBit(uint64_t word);
 
   friend ostream &operator<<(ostream &out, const TriangleBoolSquareMatrix &matrix);
 
@@ -57,6 +110,11 @@ public:
 
   void readFromStreamFull(istream &in);
 
+  // Rows of neighbours delta and varint coded by encodeAdjacency, a few bytes a link for sparse graphs
+  void writeToStreamCompressed(ostream &out) const;
+
+  void readFromStreamCompressed(istream &in);
+
   bool operator==(const TriangleBoolSquareMatrix &second) const;
 };
 
@@ -0,0 +1,325 @@
+#include "VectorExport.h"
+#include "TextIO.h"
+#include "Link.h"
+#include "TextFactory.h"
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+
+using std::min;
+using std::max;
+using std::numeric_limits;
+
+// Decimals of coordinates, a hundredth of a unit
+const int coordinateDecimals = 2;
+// Decimals of the PDF page transform, enough for the scale of a plane of a billion units; PDF has no exponents
+const int matrixDecimals = 10;
+// Links and discs in one SVG path or PDF painting operator, which keeps both small enough for viewers
+const size_t shapesPerPath = 1024;
+// Largest side of a PDF page in points
+const double maxPageSide = 14400;
+
+// Calls function(node) for the listed nodes or all of them
+template<typename Function>
+void forEachNode(const GraphCore &core, const vector<size_t> *nodes, Function function) {
+  if (nodes != nullptr) {
+    for (auto node:*nodes) {
+      function(GraphCore::NodeId(node));
+    }
+  } else {
+    for (GraphCore::NodeId node = 0; node < core.getNumberOfNodes(); ++node) {
+      function(node);
+    }
+  }
+}
+
+template<typename Function>
+void forEachLink(const GraphCore &core, const vector<size_t> *links, Function function) {
+  if (links != nullptr) {
+    for (auto link:*links) {
+      function(link);
+    }
+  } else {
+    for (size_t link = 0; link < core.getNumberOfLinks(); ++link) {
+      function(link);
+    }
+  }
+}
+
+// Hex colour for SVG
+string toHex(sf::Color color) {
+  char hex[8];
+  std::snprintf(hex, sizeof hex, "#%02x%02x%02x", color.r, color.g, color.b);
+  return hex;
+}
+
+// Colour operands for PDF, three fractions of one
+void writePdfColor(TextWriter &writer, sf::Color color) {
+  for (auto channel:{color.r, color.g, color.b}) {
+    writer.writeFixed(channel / 255., 3);
+    writer.put(' ');
+  }
+}
+
+void writeSvg(TextWriter &writer, const GraphCore &core, const vector<size_t> *nodes,
+                     const vector<size_t> *links, double left, double top, double width, double height) {
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto &textFactory = TextFactory::getTextFactory();
+  auto writeCoordinate = [&writer](double value) {
+    writer.writeFixed(value, coordinateDecimals);
+  };
+
+  writer.write(R"(<?xml version="1.0" encoding="UTF-8"?>)" "\n"
+               R"(<svg xmlns="http://www.w3.org/2000/svg" viewBox=")");
+  writeCoordinate(left);
+  writer.put(' ');
+  writeCoordinate(top);
+  writer.put(' ');
+  writeCoordinate(width);
+  writer.put(' ');
+  writeCoordinate(height);
+  writer.write(R"(" width=")");
+  writeCoordinate(width);
+  writer.write(R"(" height=")");
+  writeCoordinate(height);
+  writer.write("\">\n");
+
+  writer.write(R"(<g fill="none" stroke=")" + toHex(Link::color) + R"(" stroke-width=")");
+  writer.writeDouble(Link::width);
+  writer.write("\">\n");
+  size_t inPath = 0;
+  forEachLink(core, links, [&](size_t link) {
+    writer.write(inPath == 0 ? R"(<path d=")" : " ");
+    auto[first, second] = core.getLink(link);
+    writer.put('M');
+    writeCoordinate(core.getX(first));
+    writer.put(' ');
+    writeCoordinate(core.getY(first));
+    writer.put('L');
+    writeCoordinate(core.getX(second));
+    writer.put(' ');
+    writeCoordinate(core.getY(second));
+    if (++inPath == shapesPerPath) {
+      writer.write("\"/>\n");
+      inPath = 0;
+    }
+  });
+  if (inPath > 0) {
+    writer.write("\"/>\n");
+  }
+  writer.write("</g>\n");
+
+  writer.write(R"(<g fill=")" + toHex(nodeSettings.color) + "\">\n");
+  forEachNode(core, nodes, [&](GraphCore::NodeId node) {
+    writer.write(R"(<circle cx=")");
+    writeCoordinate(core.getX(node));
+    writer.write(R"(" cy=")");
+    writeCoordinate(core.getY(node));
+    writer.write(R"(" r=")");
+    writeCoordinate(nodeSettings.radius);
+    writer.write("\"/>\n");
+  });
+  writer.write("</g>\n");
+
+  writer.write(R"(<g font-family="Arial, Helvetica, sans-serif" font-size=")");
+  writer.writeSize(textFactory.getCharacterSize());
+  writer.write(R"(" text-anchor="middle" dominant-baseline="central" fill=")" +
+               toHex(textFactory.getCharacterColor()) + "\">\n");
+  forEachNode(core, nodes, [&](GraphCore::NodeId node) {
+    writer.write(R"(<text x=")");
+    writeCoordinate(core.getX(node));
+    writer.write(R"(" y=")");
+    writeCoordinate(core.getY(node));
+    writer.write("\">");
+    for (auto c:core.getName(node)) {
+      switch (c) {
+        case '&':
+          writer.write("&amp;");
+          break;
+        case '<':
+          writer.write("&lt;");
+          break;
+        case '>':
+          writer.write("&gt;");
+          break;
+        default:
+          writer.put(c);
+      }
+    }
+    writer.write("</text>\n");
+  });
+  writer.write("</g>\n</svg>\n");
+}
+
+// Width of the text in the loaded font, which Helvetica of the PDF matches in metrics, or an average guess
+double getTextWidth(const string &text, unsigned characterSize) {
+  try {
+    const auto &bitmaps = TextFactory::getTextFactory().getGlyphBitmaps();
+    double width = 0;
+    for (auto c:text) {
+      width += bitmaps.getGlyph(static_cast<unsigned char>(c), characterSize).advance;
+    }
+    return width;
+  } catch (const std::runtime_error &) {
+    return .55 * characterSize * double(text.size());
+  }
+}
+
+void writePdf(TextWriter &writer, const GraphCore &core, const vector<size_t> *nodes,
+                     const vector<size_t> *links, double left, double top, double width, double height) {
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  auto &textFactory = TextFactory::getTextFactory();
+  auto writeNumber = [&writer](double value) {
+    writer.writeFixed(value, coordinateDecimals);
+    writer.put(' ');
+  };
+  double scale = min(1., maxPageSide / max(width, height));
+
+  // Objects: 1 catalog, 2 pages, 3 page, 4 content, 5 length of the content, 6 font
+  vector<size_t> offsets(7);
+  writer.write("%PDF-1.4\n");
+  offsets[1] = writer.getPosition();
+  writer.write("1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+  offsets[2] = writer.getPosition();
+  writer.write("2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n");
+  offsets[3] = writer.getPosition();
+  writer.write("3 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 ");
+  writeNumber(width * scale);
+  writeNumber(height * scale);
+  writer.write("] /Contents 4 0 R /Resources << /Font << /F1 6 0 R >> >> >>\nendobj\n");
+  offsets[4] = writer.getPosition();
+  writer.write("4 0 obj\n<< /Length 5 0 R >>\nstream\n");
+  auto contentStart = writer.getPosition();
+
+  // y grows down in the plane and up on the page
+  for (auto entry:{scale, 0., 0., -scale, -left * scale, (top + height) * scale}) {
+    writer.writeFixed(entry, matrixDecimals);
+    writer.put(' ');
+  }
+  writer.write("cm\n");
+
+  writePdfColor(writer, Link::color);
+  writer.write("RG ");
+  writeNumber(Link::width);
+  writer.write("w 0 J\n");
+  size_t inPath = 0;
+  forEachLink(core, links, [&](size_t link) {
+    auto[first, second] = core.getLink(link);
+    writeNumber(core.getX(first));
+    writeNumber(core.getY(first));
+    writer.write("m ");
+    writeNumber(core.getX(second));
+    writeNumber(core.getY(second));
+    writer.write("l\n");
+    if (++inPath == shapesPerPath) {
+      writer.write("S\n");
+      inPath = 0;
+    }
+  });
+  if (inPath > 0) {
+    writer.write("S\n");
+  }
+
+  // Circles as four Bézier quarters
+  writePdfColor(writer, nodeSettings.color);
+  writer.write("rg\n");
+  double radius = nodeSettings.radius, handle = .5523 * radius;
+  inPath = 0;
+  forEachNode(core, nodes, [&](GraphCore::NodeId node) {
+    double x = core.getX(node), y = core.getY(node);
+    writeNumber(x + radius);
+    writeNumber(y);
+    writer.write("m ");
+    double quarters[][6] = {{x + radius, y + handle, x + handle, y + radius, x, y + radius},
+                            {x - handle, y + radius, x - radius, y + handle, x - radius, y},
+                            {x - radius, y - handle, x - handle, y - radius, x, y - radius},
+                            {x + handle, y - radius, x + radius, y - handle, x + radius, y}};
+    for (const auto &quarter:quarters) {
+      for (auto value:quarter) {
+        writeNumber(value);
+      }
+      writer.write("c ");
+    }
+    writer.write("h\n");
+    if (++inPath == shapesPerPath) {
+      writer.write("f\n");
+      inPath = 0;
+    }
+  });
+  if (inPath > 0) {
+    writer.write("f\n");
+  }
+
+  // Text matrices flip the glyphs back upright, the baseline is a third of the size below the centre
+  auto characterSize = unsigned(textFactory.getCharacterSize());
+  writePdfColor(writer, textFactory.getCharacterColor());
+  writer.write("rg BT /F1 ");
+  writer.writeSize(characterSize);
+  writer.write(" Tf\n");
+  forEachNode(core, nodes, [&](GraphCore::NodeId node) {
+    const auto &name = core.getName(node);
+    writer.write("1 0 0 -1 ");
+    writeNumber(core.getX(node) - getTextWidth(name, characterSize) / 2);
+    writeNumber(core.getY(node) + .35 * characterSize);
+    writer.write("Tm (");
+    for (auto c:name) {
+      if (c == '(' || c == ')' || c == '\\') {
+        writer.put('\\');
+      }
+      writer.put(c);
+    }
+    writer.write(") Tj\n");
+  });
+  writer.write("ET\n");
+
+  auto contentLength = writer.getPosition() - contentStart;
+  writer.write("endstream\nendobj\n");
+  offsets[5] = writer.getPosition();
+  writer.write("5 0 obj\n");
+  writer.writeSize(contentLength);
+  writer.write("\nendobj\n");
+  offsets[6] = writer.getPosition();
+  writer.write("6 0 obj\n<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica /Encoding /WinAnsiEncoding >>\n"
+               "endobj\n");
+
+  auto xrefOffset = writer.getPosition();
+  writer.write("xref\n0 7\n0000000000 65535 f \n");
+  for (size_t object = 1; object < offsets.size(); ++object) {
+    char entry[24];
+    std::snprintf(entry, sizeof entry, "%010zu 00000 n \n", offsets[object]);
+    writer.write(entry, 20);
+  }
+  writer.write("trailer\n<< /Size 7 /Root 1 0 R >>\nstartxref\n");
+  writer.writeSize(xrefOffset);
+  writer.write("\n%%EOF\n");
+}
+
+sf::Rect<double> getImageArea(const GraphCore &core, const vector<size_t> *nodes) {
+  // Discs and labels reach past the centres of the nodes
+  auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+  double margin = max(nodeSettings.radius, Link::width) + double(TextFactory::getTextFactory().getCharacterSize());
+  double minX = numeric_limits<double>::max(), minY = minX;
+  double maxX = numeric_limits<double>::lowest(), maxY = maxX;
+  forEachNode(core, nodes, [&](GraphCore::NodeId node) {
+    minX = min(minX, core.getX(node));
+    maxX = max(maxX, core.getX(node));
+    minY = min(minY, core.getY(node));
+    maxY = max(maxY, core.getY(node));
+  });
+  if (minX > maxX) {
+    minX = minY = maxX = maxY = 0;
+  }
+  return sf::Rect<double>(minX - margin, minY - margin, maxX - minX + 2 * margin, maxY - minY + 2 * margin);
+}
+
+void writeVectorImage(ostream &out, const GraphCore &core, const vector<size_t> *nodes, const vector<size_t> *links,
+                      VectorFormat format) {
+  auto area = getImageArea(core, nodes);
+  TextWriter writer(out);
+  if (format == VectorFormat::Svg) {
+    writeSvg(writer, core, nodes, links, area.left, area.top, area.width, area.height);
+  } else {
+    writePdf(writer, core, nodes, links, area.left, area.top, area.width, area.height);
+  }
+  writer.flush();
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "GraphCore.h"
+#include <SFML/Graphics.hpp>
+#include <iostream>
+
+using std::ostream;
+
+enum class VectorFormat {
+  Svg,
+  Pdf
+};
+
+// Bounding box of the listed nodes, or all of them for nullptr, grown by the margin their discs and labels need. Both
+// vector and tiled images show this area.
+sf::Rect<double> getImageArea(const GraphCore &core, const vector<size_t> *nodes);
+
+// Writes links, discs and labels as Graph::draw shows them, element by element through a TextWriter, so memory
+// does not grow with the graph. Nodes and links are the listed ones, or all of them for nullptr. The picture is
+// the image area, one unit of the plane per unit of the document; a PDF page is scaled down to the 14400 points
+// viewers accept.
+void writeVectorImage(ostream &out, const GraphCore &core, const vector<size_t> *nodes, const vector<size_t> *links,
+                      VectorFormat format);
@@ -1,8 +1,18 @@
 #include "TextFactory.h"
 #include "Graph.h"
+#include "BatchGenerator.h"
+#include "BatchRenderer.h"
+#include "GraphJob.h"
+#include "CompressedAdjacency.h"
+#include "MappedFile.h"
+#include "GraphViewport.h"
 #include <TGUI/TGUI.hpp>
 #include <filesystem>
 #include <fstream>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <optional>
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -16,19 +26,108 @@ shared_ptr<tgui::Label> createCentredLabel(const sf::String &text) {
   return newLabel;
 }
 
-void saveImageOfGraph(const Graph &graph, const string &name) {
+void saveImageOfGraph(const Graph &graph, const string &name, DiscTexture &discTexture) {
   sf::RenderTexture texture;
   texture.create(600, 600);
 
   texture.clear(sf::Color::White);
-  texture.draw(graph);
+  graph.draw(texture, sf::RenderStates::Default, discTexture);
   texture.display();
 
   texture.getTexture().copyToImage().saveToFile("img/" + name + ".png");
 }
 
+void saveVectorImageOfGraph(const Graph &graph, const string &name, VectorFormat format) {
+  auto path = "img/" + name + (format == VectorFormat::Svg ? ".svg" : ".pdf");
+  ofstream out(path, ios::binary);
+  if (!out) {
+    throw runtime_error("Unable to open " + path);
+  }
+  graph.exportVectorImage(out, format);
+}
+
+void saveTiledImageOfGraph(const Graph &graph, const string &name, const TiledImageSettings &settings,
+                           RenderBackend backend) {
+  auto path = "img/" + name + ".png";
+  ofstream out(path, ios::binary);
+  if (!out) {
+    throw runtime_error("Unable to open " + path);
+  }
+  graph.exportTiledImage(out, settings, backend);
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Times saving and loading a generated planar graph as matrix and nodes text, through TextIO as Graph does, then
+// through operator<< and operator>> as the formats were written and read before it
+void benchmarkTextFormat(size_t numberOfNodes, unsigned seed) {
+  const string name = "benchmark";
+  fs::create_directories("matrix");
+  fs::create_directories("nodes");
+  double nodeRadius = 10, maxCoord = max(600., 4 * nodeRadius * ceil(sqrt(2. * double(numberOfNodes))));
+  mt19937 engine(seed);
+  auto graph = Graph::generatePlanar(numberOfNodes, maxCoord, nodeRadius, engine);
+  const auto &core = graph.getCore();
+
+  auto start = chrono::steady_clock::now();
+  graph.save(name);
+  double textIOSave = secondsSince(start);
+  auto matrixSize = fs::file_size("matrix/" + name), nodesSize = fs::file_size("nodes/" + name);
+  start = chrono::steady_clock::now();
+  Graph loaded(nodeRadius);
+  loaded.load(name);
+  double textIOLoad = secondsSince(start);
+  if (loaded.getCore().getNumberOfLinks() != core.getNumberOfLinks()) {
+    throw runtime_error("Benchmark graph did not load back the same");
+  }
+
+  TriangleBoolSquareMatrix matrix(numberOfNodes);
+  for (const auto &[first, second]:core.getLinks()) {
+    matrix.at(max(first, second), min(first, second)) = true;
+  }
+  start = chrono::steady_clock::now();
+  {
+    ofstream matrixOut("matrix/" + name);
+    matrix.writeToStreamFull(matrixOut);
+    ofstream nodesOut("nodes/" + name);
+    nodesOut << numberOfNodes << '\n';
+    for (GraphCore::NodeId i = 0; i < numberOfNodes; ++i) {
+      nodesOut << core.getX(i) << ' ' << core.getY(i) << ' ' << core.getName(i) << '\n';
+    }
+  }
+  double streamSave = secondsSince(start);
+  start = chrono::steady_clock::now();
+  {
+    ifstream matrixIn("matrix/" + name);
+    TriangleBoolSquareMatrix readMatrix;
+    readMatrix.readFromStreamFull(matrixIn);
+    ifstream nodesIn("nodes/" + name);
+    size_t n;
+    nodesIn >> n;
+    vector<double> xs(n), ys(n);
+    vector<string> names(n);
+    for (size_t i = 0; i < n; ++i) {
+      nodesIn >> xs[i] >> ys[i];
+      nodesIn.get();
+      getline(nodesIn, names[i]);
+    }
+  }
+  double streamLoad = secondsSince(start);
+  fs::remove("matrix/" + name);
+  fs::remove("nodes/" + name);
+
+  cout << numberOfNodes << " nodes, " << core.getNumberOfLinks() << " links, " << matrixSize / 1e6
+       << " MB matrix, " << nodesSize / 1e6 << " MB nodes" << endl;
+  cout << "TextIO: save " << textIOSave << " s, load " << textIOLoad << " s" << endl;
+  cout << "operator<< and operator>>: save " << streamSave << " s, load " << streamLoad << " s" << endl;
+}
+
 int main(int argc, char **argv) {
-  if (argc == 1) {
+  if (argc == 1 || string(argv[1]) == "--frame-limit") {
+    // Frames per second while something changes, zero for no limit
+    unsigned frameLimit = argc > 2 ? unsigned(stoul(argv[2])) : 60;
     {
       auto &textFactory = TextFactory::getTextFactory();
       textFactory.loadFontFromFile("../fonts/Arial.TTF");
@@ -40,11 +139,17 @@ int main(int argc, char **argv) {
     }
 
     Graph graph;
+    // Generators and loading build the next graph here while the current one is drawn
+    GraphJob job;
 
     sf::RenderWindow window(sf::VideoMode(1200, 600), "My window");
+    window.setFramerateLimit(frameLimit);
     tgui::Gui gui(window);
+    // Discs of every graph drawn while the window is open, made in its context and gone before it
+    DiscTexture discTexture;
 
     shared_ptr<tgui::Canvas> graphCanvas;
+    shared_ptr<tgui::ProgressBar> jobProgressBar;
     {
       auto centralLayout = tgui::HorizontalLayout::create();
       {
@@ -52,6 +157,7 @@ int main(int argc, char **argv) {
 
         shared_ptr<tgui::EditBox> nBox;
         shared_ptr<tgui::EditBox> kBox;
+        shared_ptr<tgui::EditBox> fractionBox;
         {
           auto settingsLayout = tgui::HorizontalLayout::create();
           {
@@ -73,8 +179,13 @@ int main(int argc, char **argv) {
               size_t characterSize;
               try {
                 characterSize = stod(newString);
-              } catch (const exception &e) {}
-              TextFactory::getTextFactory().setCharacterSize(characterSize);
+              } catch (const exception &e) {
+                return;
+              }
+              auto &textFactory = TextFactory::getTextFactory();
+              textFactory.setCharacterSize(characterSize);
+              // Labels of the next frame find their glyphs in the atlas instead of rasterizing them while drawing
+              textFactory.preloadGlyphs(TextFactory::nameCharacters, RenderBackend::OpenGL);
             });
             characterSizeBox->setText("19");
             settingsLayout->add(characterSizeBox);
@@ -92,25 +203,60 @@ int main(int argc, char **argv) {
 
             kBox = tgui::EditBox::create();
             nkLayout->add(kBox);
+
+            nkLayout->add(createCentredLabel("links: "), .15);
+
+            fractionBox = tgui::EditBox::create();
+            fractionBox->setText("0.5");
+            nkLayout->add(fractionBox);
           }
           controlsLayout->add(nkLayout);
 
           auto generatorsLayout = tgui::HorizontalLayout::create();
           {
             auto planarGenerator = tgui::Button::create("Generate planar graph");
-            planarGenerator->connect(planarGenerator->onClick.getName(), [nBox, &graph]() {
+            planarGenerator->connect(planarGenerator->onClick.getName(), [nBox, &job]() {
               size_t numberOfNodes;
               try {
                 numberOfNodes = stoull(nBox->getText().toAnsiString());
               } catch (const exception &e) {
                 return;
               }
-              graph = Graph::generatePlanar(numberOfNodes, 600);
+              // Read here, the radius box changes the settings while the job runs
+              auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+              job.start([numberOfNodes, nodeRadius](JobProgress &progress) {
+                mt19937 engine(random_device{}());
+                return Graph::generatePlanar(numberOfNodes, 600, nodeRadius, engine, PlanarLinkSampling::RandomPairs,
+                                             NodePlacement::Lattice, AdjacencyStorage::Automatic, &progress);
+              });
             });
             generatorsLayout->add(planarGenerator);
 
+            auto delaunayGenerator = tgui::Button::create("Generate Delaunay graph");
+            delaunayGenerator->connect(delaunayGenerator->onClick.getName(), [nBox, fractionBox, &job]() {
+              size_t numberOfNodes;
+              try {
+                numberOfNodes = stoull(nBox->getText().toAnsiString());
+              } catch (const exception &e) {
+                return;
+              }
+              double linkFraction;
+              try {
+                linkFraction = stod(fractionBox->getText().toAnsiString());
+              } catch (const exception &e) {
+                return;
+              }
+              auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+              job.start([numberOfNodes, nodeRadius, linkFraction](JobProgress &progress) {
+                mt19937 engine(random_device{}());
+                return Graph::generateDelaunayPlanar(numberOfNodes, 600, nodeRadius, linkFraction, engine,
+                                                     NodePlacement::Lattice, AdjacencyStorage::Automatic, &progress);
+              });
+            });
+            generatorsLayout->add(delaunayGenerator);
+
             auto treeGenerator = tgui::Button::create("Generate combination tree");
-            treeGenerator->connect(treeGenerator->onClick.getName(), [nBox, kBox, &graph]() {
+            treeGenerator->connect(treeGenerator->onClick.getName(), [nBox, kBox, &job]() {
               size_t numberOfNodes;
               try {
                 numberOfNodes = stoull(nBox->getText().toAnsiString());
@@ -123,41 +269,97 @@ int main(int argc, char **argv) {
               } catch (const exception &e) {
                 return;
               }
-              graph = Graph::generateCombinationTree(numberOfNodes, numberOfLayers, 600);
+              auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+              job.start([numberOfNodes, numberOfLayers, nodeRadius](JobProgress &progress) {
+                return Graph::generateCombinationTree(numberOfNodes, numberOfLayers, 600, nodeRadius, &progress);
+              });
             });
             generatorsLayout->add(treeGenerator);
           }
           controlsLayout->add(generatorsLayout);
 
+          auto jobLayout = tgui::HorizontalLayout::create();
+          {
+            jobProgressBar = tgui::ProgressBar::create();
+            jobProgressBar->setMinimum(0);
+            jobProgressBar->setMaximum(100);
+            jobLayout->add(jobProgressBar);
+
+            auto cancelButton = tgui::Button::create("Cancel");
+            cancelButton->connect(cancelButton->onClick.getName(), [&job]() {
+              job.cancel();
+            });
+            jobLayout->add(cancelButton, .3);
+          }
+          controlsLayout->add(jobLayout);
+
           auto fileNameLayout = tgui::HorizontalLayout::create();
           shared_ptr<tgui::EditBox> fileNameBox;
+          shared_ptr<tgui::ComboBox> formatBox;
           {
             fileNameLayout->add(createCentredLabel("File name: "), .1);
 
             fileNameBox = tgui::EditBox::create();
             fileNameLayout->add(fileNameBox);
+
+            // Items in the order of GraphFileFormat
+            formatBox = tgui::ComboBox::create();
+            formatBox->addItem("text");
+            formatBox->addItem("binary");
+            formatBox->addItem("edge list");
+            formatBox->setSelectedItemByIndex(0);
+            fileNameLayout->add(formatBox, .15);
           }
           controlsLayout->add(fileNameLayout);
 
           auto saveLoadLayout = tgui::HorizontalLayout::create();
           {
             auto saveButton = tgui::Button::create("Save graph");
-            saveButton->connect(saveButton->onClick.getName(), [fileNameBox, &graph]() {
-              graph.save(fileNameBox->getText());
+            saveButton->connect(saveButton->onClick.getName(), [fileNameBox, formatBox, &graph]() {
+              try {
+                graph.save(fileNameBox->getText(), GraphFileFormat(formatBox->getSelectedItemIndex()));
+              } catch (const exception &e) {
+                cerr << e.what() << endl;
+              }
             });
             saveLoadLayout->add(saveButton);
 
             auto loadButton = tgui::Button::create("Load graph");
-            loadButton->connect(loadButton->onClick.getName(), [fileNameBox, &graph]() {
-              graph.load(fileNameBox->getText());
+            loadButton->connect(loadButton->onClick.getName(), [fileNameBox, formatBox, &job]() {
+              string name = fileNameBox->getText();
+              auto format = GraphFileFormat(formatBox->getSelectedItemIndex());
+              auto nodeRadius = Node::NodeSettings::getNodeSettings().radius;
+              job.start([name, format, nodeRadius](JobProgress &progress) {
+                Graph loaded(nodeRadius);
+                loaded.load(name, format, AdjacencyStorage::Automatic, &progress);
+                return loaded;
+              });
             });
             saveLoadLayout->add(loadButton);
 
+            // PNG of the canvas size, or the whole graph as a vector image
+            auto imageFormatBox = tgui::ComboBox::create();
+            imageFormatBox->addItem("png");
+            imageFormatBox->addItem("svg");
+            imageFormatBox->addItem("pdf");
+            imageFormatBox->setSelectedItemByIndex(0);
+
             auto saveImageButton = tgui::Button::create("Save image of graph");
-            saveImageButton->connect(saveImageButton->onClick.getName(), [fileNameBox, &graph]() {
-              saveImageOfGraph(graph, fileNameBox->getText());
+            saveImageButton->connect(saveImageButton->onClick.getName(), [fileNameBox, imageFormatBox, &graph, &discTexture]() {
+              auto index = imageFormatBox->getSelectedItemIndex();
+              try {
+                if (index == 0) {
+                  saveImageOfGraph(graph, fileNameBox->getText(), discTexture);
+                } else {
+                  saveVectorImageOfGraph(graph, fileNameBox->getText(),
+                                         index == 1 ? VectorFormat::Svg : VectorFormat::Pdf);
+                }
+              } catch (const exception &e) {
+                cerr << e.what() << endl;
+              }
             });
             saveLoadLayout->add(saveImageButton);
+            saveLoadLayout->add(imageFormatBox, .3);
           }
           controlsLayout->add(saveLoadLayout);
 
@@ -206,25 +408,119 @@ int main(int argc, char **argv) {
       gui.add(centralLayout);
     }
 
+    // The window is redrawn only after events, a finished job, a step of progress or a change of the graph and
+    // its settings. Every event counts, as widgets change their look on hover and the canvas loses its content
+    // on resize.
+    bool isDirty = true;
+    unsigned shownProgress = 0;
+    // The wheel zooms around the mouse over the canvas, dragging with the left button pans it
+    GraphViewport viewport;
+    bool isPanning = false;
+    sf::Vector2f lastMousePixel;
+    auto getCanvasSize = [&graphCanvas]() {
+      return sf::Vector2f(graphCanvas->getSize().x, graphCanvas->getSize().y);
+    };
+    // Pixel of the canvas under the mouse at (x, y) of the window, nullopt outside of the canvas
+    auto getCanvasPixel = [&graphCanvas, &getCanvasSize](int x, int y) -> optional<sf::Vector2f> {
+      auto position = graphCanvas->getAbsolutePosition();
+      sf::Vector2f pixel(float(x) - position.x, float(y) - position.y), size = getCanvasSize();
+      if (pixel.x < 0 || pixel.y < 0 || pixel.x >= size.x || pixel.y >= size.y) {
+        return nullopt;
+      }
+      return pixel;
+    };
+    auto handleEvent = [&](const sf::Event &event) {
+      if (event.type == sf::Event::Closed ||
+          (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)) {
+        window.close();
+      }
+      if (event.type == sf::Event::MouseWheelScrolled) {
+        if (auto pixel = getCanvasPixel(event.mouseWheelScroll.x, event.mouseWheelScroll.y)) {
+          viewport.zoom(pow(1.2, -event.mouseWheelScroll.delta), *pixel, getCanvasSize());
+        }
+      } else if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
+        if (auto pixel = getCanvasPixel(event.mouseButton.x, event.mouseButton.y)) {
+          isPanning = true;
+          lastMousePixel = *pixel;
+        }
+      } else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+        isPanning = false;
+      } else if (event.type == sf::Event::MouseMoved && isPanning) {
+        auto position = graphCanvas->getAbsolutePosition();
+        sf::Vector2f pixel(float(event.mouseMove.x) - position.x, float(event.mouseMove.y) - position.y);
+        viewport.pan(sf::Vector2f(pixel.x - lastMousePixel.x, pixel.y - lastMousePixel.y));
+        lastMousePixel = pixel;
+      }
+      gui.handleEvent(event);
+      isDirty = true;
+    };
+    // A running job is polled this often when nothing else happens
+    const auto jobPollInterval = chrono::milliseconds(frameLimit > 0 ? 1000 / frameLimit : 16);
+
     while (window.isOpen()) {
       sf::Event event{};
+      // Nothing changes by itself without a job, so the loop sleeps till the next event
+      if (!isDirty && !job.isRunning() && !graph.needsRedraw() && window.waitEvent(event)) {
+        handleEvent(event);
+      }
       while (window.pollEvent(event)) {
-        if (event.type == sf::Event::Closed ||
-            (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)) {
-          window.close();
+        handleEvent(event);
+      }
+
+      try {
+        // A new graph is shown whole
+        if (job.collect(graph)) {
+          viewport.fit(graph.getBounds(), getCanvasSize());
+          isDirty = true;
         }
-        gui.handleEvent(event);
+      } catch (const exception &e) {
+        cerr << e.what() << endl;
+      }
+      auto progress = job.isRunning() ? unsigned(job.getProgress() * 100) : 0;
+      if (progress != shownProgress) {
+        shownProgress = progress;
+        jobProgressBar->setValue(progress);
+        isDirty = true;
       }
+      isDirty |= graph.needsRedraw();
 
+      if (!isDirty) {
+        this_thread::sleep_for(jobPollInterval);
+        continue;
+      }
       graphCanvas->clear(sf::Color::White);
-      graphCanvas->draw(graph);
+      graphCanvas->setView(viewport.getView(getCanvasSize()));
+      graph.draw(graphCanvas->getRenderTexture(), sf::RenderStates::Default, discTexture);
       graphCanvas->display();
 
       window.clear(sf::Color::White);
       gui.draw();
       window.display();
+      isDirty = false;
+    }
+  } else if (string(argv[1]) == "--generate") {
+    if (argc < 5) {
+      cerr << "Usage: " << argv[0] << " --generate <number of graphs> <number of nodes> <seed> [threads]" << endl;
+      return 1;
+    }
+    size_t numberOfGraphs = stoull(argv[2]), numberOfNodes = stoull(argv[3]);
+    auto seed = unsigned(stoul(argv[4]));
+    size_t numberOfThreads = argc > 5 ? stoull(argv[5]) : 0;
+
+    auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+    nodeSettings.radius = 10;
+    // Leave room for twice as many nodes, so that random placement stays fast
+    double maxCoord = max(600., 4 * nodeSettings.radius * ceil(sqrt(2. * double(numberOfNodes))));
+
+    BatchGenerator(numberOfThreads, seed).generatePlanar(numberOfGraphs, numberOfNodes, maxCoord, "generated_");
+  } else if (string(argv[1]) == "--export") {
+    string imageFormat = argc > 2 ? argv[2] : "";
+    if (argc < 4 || (imageFormat != "svg" && imageFormat != "pdf" && imageFormat != "png")) {
+      cerr << "Usage: " << argv[0] << " --export <svg|pdf> <graph name> [text|binary|edges]" << endl;
+      cerr << "       " << argv[0] << " --export png <graph name> [text|binary|edges] [width] [height] [software|gl]"
+           << endl;
+      return 1;
     }
-  } else {
     {
       auto &textFactory = TextFactory::getTextFactory();
       textFactory.loadFontFromFile("../fonts/Arial.TTF");
@@ -236,28 +532,88 @@ int main(int argc, char **argv) {
       nodeSettings.color = sf::Color(94, 129, 181);
       nodeSettings.radius = 10;
     }
-    fs::path dir = argv[1];
-    for (const auto &entry:fs::directory_iterator(dir)) {
-      auto fileName = entry.path().filename().string();
-      if (fileName.find("test_") == 0 && fileName.find("_result") == string::npos) {
-        ifstream matrixIn(entry.path());
-        matrixIn.ignore(numeric_limits<streamsize>::max(), '\n');
-        matrixIn.ignore(numeric_limits<streamsize>::max(), '\n');
-        ifstream nodesIn("nodes/" + fileName);
-        Graph graph;
-        graph.load(matrixIn, nodesIn);
-
-        ifstream subgraphIn(entry.path().string() + "_result");
-        vector<size_t> subgraph;
-        while (subgraphIn.get() != '}') {
-          size_t node;
-          subgraphIn >> node;
-          subgraph.push_back(node);
-        }
-        graph.showSubgraph(subgraph);
-        saveImageOfGraph(graph, fileName + "_sel");
+    string formatName = argc > 4 ? argv[4] : "text";
+    auto format = formatName == "binary" ? GraphFileFormat::Binary :
+                  formatName == "edges" ? GraphFileFormat::EdgeList : GraphFileFormat::Text;
+    Graph graph;
+    graph.load(argv[3], format);
+    if (imageFormat == "png") {
+      // Drawn in tiles, so any size fits in memory and in the largest texture
+      TiledImageSettings settings;
+      settings.width = argc > 5 ? unsigned(stoul(argv[5])) : 600;
+      settings.height = argc > 6 ? unsigned(stoul(argv[6])) : settings.width;
+      auto backend = argc > 7 && string(argv[7]) == "gl" ? RenderBackend::OpenGL : RenderBackend::Software;
+      saveTiledImageOfGraph(graph, argv[3], settings, backend);
+    } else {
+      saveVectorImageOfGraph(graph, argv[3], imageFormat == "svg" ? VectorFormat::Svg : VectorFormat::Pdf);
+    }
+  } else if (string(argv[1]) == "--benchmark") {
+    if (argc < 3) {
+      cerr << "Usage: " << argv[0] << " --benchmark <number of nodes> [seed]" << endl;
+      return 1;
+    }
+    benchmarkTextFormat(stoull(argv[2]), argc > 3 ? unsigned(stoul(argv[3])) : 1);
+  } else if (string(argv[1]) == "--compression-stats") {
+    if (argc < 3) {
+      cerr << "Usage: " << argv[0] << " --compression-stats <graph files>..." << endl;
+      return 1;
+    }
+    for (int k = 2; k < argc; ++k) {
+      MappedFile file(argv[k]);
+      auto core = readGraphFile(file.data(), file.size());
+      auto n = core.getNumberOfNodes();
+      auto encoded = encodeAdjacency(n, core.getLinks());
+
+      // Decoding is repeated for at least a tenth of a second to time it
+      size_t decodedLinks = 0, rounds = 0;
+      auto start = chrono::steady_clock::now();
+      double seconds = 0;
+      while (seconds < .1) {
+        decodeAdjacency(encoded.data(), encoded.size(), n, [&decodedLinks](size_t, size_t) {
+          ++decodedLinks;
+        });
+        ++rounds;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
       }
+
+      double packedBytes = double(n) * double(n) / 16, compressedBytes = double(max(encoded.size(), size_t(1)));
+      cout << argv[k] << ": " << n << " nodes, " << core.getNumberOfLinks() << " links, " << encoded.size()
+           << " bytes compressed, " << compressedBytes * 8 / double(max(core.getNumberOfLinks(), size_t(1)))
+           << " bits per link, " << packedBytes / compressedBytes << "x smaller than the packed matrix, "
+           << double(core.getNumberOfLinks() * 2 * sizeof(uint32_t)) / compressedBytes
+           << "x smaller than the link list, decoded at " << double(decodedLinks) / seconds / 1e6 << " M links/s, "
+           << double(encoded.size() * rounds) / seconds / 1e6 << " MB/s" << endl;
+    }
+  } else {
+    {
+      auto &textFactory = TextFactory::getTextFactory();
+      textFactory.loadFontFromFile("../fonts/Arial.TTF");
+      textFactory.setCharacterSize(19);
+      textFactory.setCharacterColor(sf::Color::Black);
+    }
+    {
+      auto &nodeSettings = Node::NodeSettings::getNodeSettings();
+      nodeSettings.color = sf::Color(94, 129, 181);
+      nodeSettings.radius = 10;
+    }
+    // "--software" first draws on the CPU, then the directory, parsing threads and encoding threads, zero for one
+    // per hardware thread
+    bool isSoftware = string(argv[1]) == "--software";
+    int first = isSoftware ? 2 : 1;
+    if (argc <= first) {
+      cerr << "Usage: " << argv[0] << " [--software] <directory> [parsing threads] [encoding threads]" << endl;
+      return 1;
     }
+    size_t numberOfParseThreads = argc > first + 1 ? stoull(argv[first + 1]) : 0;
+    size_t numberOfEncodeThreads = argc > first + 2 ? stoull(argv[first + 2]) : 0;
+    auto backend = isSoftware ? RenderBackend::Software : RenderBackend::OpenGL;
+    auto stats = BatchRenderer(numberOfParseThreads, numberOfEncodeThreads, backend).render(argv[first], "img/");
+    auto perGraph = [&stats](double seconds) {
+      return seconds / double(max(stats.numberOfGraphs, size_t(1))) * 1000;
+    };
+    cout << stats.numberOfGraphs << " graphs in " << stats.totalSeconds << " s, " << stats.getGraphsPerSecond()
+         << " graphs/s; per graph " << perGraph(stats.parseSeconds) << " ms parsing, " << perGraph(stats.renderSeconds)
+         << " ms drawing, " << perGraph(stats.encodeSeconds) << " ms encoding" << endl;
   }
   return 0;
 }